@@ -0,0 +1,215 @@
+#include "Bitboard.h"
+
+Bitboard knightAttacks[64];
+Bitboard kingAttacks[64];
+Bitboard pawnAttacks[2][64];
+Bitboard columnBitboards[8];
+Bitboard adjacentColumns[8];
+Bitboard forwardSquares[2][64];
+Bitboard pawnAttackSpan[2][64];
+Bitboard betweenSquares[64][64];
+
+SlidingAttacks bishopMagics[64];
+SlidingAttacks rookMagics[64];
+
+// Shared tables that hold the attacks of every square for every relevant occupancy
+static Bitboard bishopAttackTable[0x1480];
+static Bitboard rookAttackTable[0x19000];
+
+// Row and column changes of the directions in which bishops and rooks slide
+static const int bishopDirections[4][2] = { { -1, -1 }, { -1, 1 }, { 1, -1 }, { 1, 1 } };
+static const int rookDirections[4][2] = { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } };
+
+// Get a bitboard with the square at the given offsets from a square, or an empty bitboard if it is not on the board
+static Bitboard offsetSquare(const int square, const int rowChange, const int columnChange)
+{
+	int row = (square >> 3) + rowChange;
+	int column = (square & 7) + columnChange;
+
+	if (row < 0 || row >= 8 || column < 0 || column >= 8)
+		return 0;
+
+	return squareBitboard(squareIndex(row, column));
+}
+
+// Compute the squares attacked by a sliding piece on a square by walking every ray until it meets an occupied square
+static Bitboard slidingAttacks(const int square, const Bitboard occupied, const int directions[4][2])
+{
+	Bitboard attacks = 0;
+
+	for (int direction = 0; direction < 4; direction++)
+	{
+		int row = (square >> 3) + directions[direction][0];
+		int column = (square & 7) + directions[direction][1];
+
+		while (row >= 0 && row < 8 && column >= 0 && column < 8)
+		{
+			attacks |= squareBitboard(squareIndex(row, column));
+			if (occupied & squareBitboard(squareIndex(row, column)))
+				break;
+
+			row += directions[direction][0];
+			column += directions[direction][1];
+		}
+	}
+
+	return attacks;
+}
+
+#if !defined(USE_PEXT)
+// Pseudo random number generator with a fixed seed so the magic numbers are the same on every run (xorshift64*)
+static uint64_t nextRandom(uint64_t& state)
+{
+	state ^= state >> 12;
+	state ^= state << 25;
+	state ^= state >> 27;
+	return state * 0x2545F4914F6CDD1DULL;
+}
+#endif
+
+// Fill the sliding attack data of one piece type for every square, finding a magic number for each square unless PEXT is used
+static void initializeSlidingAttacks(SlidingAttacks magics[64], Bitboard* table, const int directions[4][2])
+{
+#if !defined(USE_PEXT)
+	// Every occupancy of the current square with its attacks, and the attempt that last wrote each entry of the attack table (so it does not have to be cleared between attempts)
+	static Bitboard occupancies[4096], references[4096];
+	static int epoch[4096];
+	int currentEpoch = 0;
+	for (int i = 0; i < 4096; i++)
+		epoch[i] = 0;
+	uint64_t randomState = 0x9E3779B97F4A7C15ULL;
+#endif
+
+	Bitboard* nextAttacks = table;
+
+	for (int square = 0; square < 64; square++)
+	{
+		SlidingAttacks& magic = magics[square];
+
+		// The squares on the edge of the board can not block a ray unless they are on the same row or column as the piece
+		int row = square >> 3, column = square & 7;
+		Bitboard edges = 0;
+		for (int i = 0; i < 8; i++)
+		{
+			if (row != 0) edges |= squareBitboard(squareIndex(0, i));
+			if (row != 7) edges |= squareBitboard(squareIndex(7, i));
+			if (column != 0) edges |= squareBitboard(squareIndex(i, 0));
+			if (column != 7) edges |= squareBitboard(squareIndex(i, 7));
+		}
+
+		magic.mask = slidingAttacks(square, 0, directions) & ~edges;
+		magic.shift = 64 - popCount(magic.mask);
+		magic.attacks = nextAttacks;
+		magic.magic = 0;
+
+		// Go through every subset of the mask (Carry-Rippler trick) and store the attacks for each one
+		int size = 0;
+		Bitboard occupied = 0;
+		do
+		{
+#if defined(USE_PEXT)
+			magic.attacks[_pext_u64(occupied, magic.mask)] = slidingAttacks(square, occupied, directions);
+#else
+			occupancies[size] = occupied;
+			references[size] = slidingAttacks(square, occupied, directions);
+#endif
+			size++;
+			occupied = (occupied - magic.mask) & magic.mask;
+		} while (occupied);
+
+		nextAttacks += size;
+
+#if !defined(USE_PEXT)
+		// Try sparse random numbers until one maps every occupancy without destructive collisions
+		for (int tried = 0; tried < size; )
+		{
+			do
+				magic.magic = nextRandom(randomState) & nextRandom(randomState) & nextRandom(randomState);
+			while (popCount((magic.mask * magic.magic) >> 56) < 6);
+
+			currentEpoch++;
+			for (tried = 0; tried < size; tried++)
+			{
+				unsigned int index = magic.index(occupancies[tried]);
+
+				if (epoch[index] < currentEpoch)
+				{
+					epoch[index] = currentEpoch;
+					magic.attacks[index] = references[tried];
+				}
+				else if (magic.attacks[index] != references[tried])
+				{
+					break;
+				}
+			}
+		}
+#endif
+	}
+}
+
+// Fill the attack tables of every piece type
+static bool initializeAttackTables()
+{
+	for (int square = 0; square < 64; square++)
+	{
+		knightAttacks[square] =
+			offsetSquare(square, -1, -2) | offsetSquare(square, -2, -1) | offsetSquare(square, -2, 1) | offsetSquare(square, -1, 2) |
+			offsetSquare(square, 1, -2) | offsetSquare(square, 2, -1) | offsetSquare(square, 2, 1) | offsetSquare(square, 1, 2);
+
+		kingAttacks[square] = 0;
+		for (int rowChange = -1; rowChange <= 1; rowChange++)
+			for (int columnChange = -1; columnChange <= 1; columnChange++)
+				if (rowChange != 0 || columnChange != 0)
+					kingAttacks[square] |= offsetSquare(square, rowChange, columnChange);
+
+		// White pawns move up the board (towards row 0) and black pawns move down
+		pawnAttacks[0][square] = offsetSquare(square, -1, -1) | offsetSquare(square, -1, 1);
+		pawnAttacks[1][square] = offsetSquare(square, 1, -1) | offsetSquare(square, 1, 1);
+	}
+
+	// The column masks are used for the pawn structure
+	for (int column = 0; column < 8; column++)
+	{
+		columnBitboards[column] = 0x0101010101010101ULL << column;
+		adjacentColumns[column] = 0;
+	}
+	for (int column = 0; column < 8; column++)
+	{
+		if (column > 0)
+			adjacentColumns[column] |= columnBitboards[column - 1];
+		if (column < 7)
+			adjacentColumns[column] |= columnBitboards[column + 1];
+	}
+
+	// White pawns advance towards row 0 so the rows in front of them have smaller indices
+	for (int square = 0; square < 64; square++)
+	{
+		int row = squareRow(square), column = squareColumn(square);
+		Bitboard rowsAbove = row == 0 ? 0 : (1ULL << (8 * row)) - 1;
+		Bitboard rowsBelow = row == 7 ? 0 : ~0ULL << (8 * (row + 1));
+
+		forwardSquares[0][square] = rowsAbove & columnBitboards[column];
+		forwardSquares[1][square] = rowsBelow & columnBitboards[column];
+		pawnAttackSpan[0][square] = rowsAbove & adjacentColumns[column];
+		pawnAttackSpan[1][square] = rowsBelow & adjacentColumns[column];
+	}
+
+	initializeSlidingAttacks(bishopMagics, bishopAttackTable, bishopDirections);
+	initializeSlidingAttacks(rookMagics, rookAttackTable, rookDirections);
+
+	// The squares between two aligned squares are the ones both of them attack along the line when the other one is the only occupied square
+	for (int from = 0; from < 64; from++)
+		for (int to = 0; to < 64; to++)
+		{
+			betweenSquares[from][to] = 0;
+			if (rookAttacks(from, 0) & squareBitboard(to))
+				betweenSquares[from][to] = rookAttacks(from, squareBitboard(to)) & rookAttacks(to, squareBitboard(from));
+			else if (bishopAttacks(from, 0) & squareBitboard(to))
+				betweenSquares[from][to] = bishopAttacks(from, squareBitboard(to)) & bishopAttacks(to, squareBitboard(from));
+		}
+
+	return true;
+}
+
+// The tables are filled once when the program starts
+static const bool attackTablesInitialized = initializeAttackTables();
@@ -0,0 +1,135 @@
+#pragma once
+#include <cstdint>
+#include "Square.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Define USE_PEXT (the ReleasePext configuration does) when building for processors with fast BMI2 instructions to index the sliding attack tables with PEXT instead of magic multiplication
+#if defined(USE_PEXT)
+#include <immintrin.h>
+#endif
+
+// 64 bit set with one bit for every square of the board (the bit of a square has the index row * 8 + column)
+typedef uint64_t Bitboard;
+
+// Get a bitboard that only contains the square with the given index
+inline Bitboard squareBitboard(const int square)
+{
+	return 1ULL << square;
+}
+
+// Count the squares contained in a bitboard
+inline int popCount(const Bitboard bitboard)
+{
+#if defined(_MSC_VER) && defined(_WIN64)
+	return (int)__popcnt64(bitboard);
+#elif defined(_MSC_VER)
+	return (int)(__popcnt((unsigned int)bitboard) + __popcnt((unsigned int)(bitboard >> 32)));
+#else
+	return __builtin_popcountll(bitboard);
+#endif
+}
+
+// Get the index of the first square contained in a non empty bitboard
+inline int leastSignificantSquare(const Bitboard bitboard)
+{
+#if defined(_MSC_VER) && defined(_WIN64)
+	unsigned long index;
+	_BitScanForward64(&index, bitboard);
+	return (int)index;
+#elif defined(_MSC_VER)
+	unsigned long index;
+	if ((unsigned int)bitboard != 0)
+	{
+		_BitScanForward(&index, (unsigned int)bitboard);
+		return (int)index;
+	}
+	_BitScanForward(&index, (unsigned int)(bitboard >> 32));
+	return (int)index + 32;
+#else
+	return __builtin_ctzll(bitboard);
+#endif
+}
+
+// Remove the first square from a non empty bitboard and return its index
+inline int popLeastSignificantSquare(Bitboard& bitboard)
+{
+	int square = leastSignificantSquare(bitboard);
+	bitboard &= bitboard - 1;
+	return square;
+}
+
+// Squares attacked by a knight standing on each square
+extern Bitboard knightAttacks[64];
+
+// Squares attacked by a king standing on each square
+extern Bitboard kingAttacks[64];
+
+// Squares attacked by a pawn of each color (index 0 for white, index 1 for black) standing on each square
+extern Bitboard pawnAttacks[2][64];
+
+// Squares of each column
+extern Bitboard columnBitboards[8];
+
+// Squares of the columns next to each column
+extern Bitboard adjacentColumns[8];
+
+// Squares in front of a pawn of each color on each square on the same column (up to the last row)
+extern Bitboard forwardSquares[2][64];
+
+// Squares in front of a pawn of each color on each square on the columns next to it (the squares it can attack while it advances)
+extern Bitboard pawnAttackSpan[2][64];
+
+// Squares strictly between two squares on the same row, column or diagonal (empty for squares that are not aligned)
+extern Bitboard betweenSquares[64][64];
+
+// Lookup data used to find the attacks of a sliding piece on a square given the occupied squares
+struct SlidingAttacks
+{
+	// Squares whose occupancy can block the piece (the last square of every ray is excluded)
+	Bitboard mask;
+	// Magic number that maps every possible occupancy of the mask to a distinct table index
+	Bitboard magic;
+	// Number of bits the product is shifted by to get the table index
+	int shift;
+	// The part of the shared attack table that belongs to this square
+	Bitboard* attacks;
+
+	// Get the index of the attacks of the piece in its part of the table
+	unsigned int index(const Bitboard occupied) const
+	{
+#if defined(USE_PEXT)
+		return (unsigned int)_pext_u64(occupied, this->mask);
+#else
+		return (unsigned int)(((occupied & this->mask) * this->magic) >> this->shift);
+#endif
+	}
+};
+
+// Sliding attack lookup data of bishops for every square
+extern SlidingAttacks bishopMagics[64];
+
+// Sliding attack lookup data of rooks for every square
+extern SlidingAttacks rookMagics[64];
+
+// Get the squares attacked by a bishop on the given square
+inline Bitboard bishopAttacks(const int square, const Bitboard occupied)
+{
+	const SlidingAttacks& magic = bishopMagics[square];
+	return magic.attacks[magic.index(occupied)];
+}
+
+// Get the squares attacked by a rook on the given square
+inline Bitboard rookAttacks(const int square, const Bitboard occupied)
+{
+	const SlidingAttacks& magic = rookMagics[square];
+	return magic.attacks[magic.index(occupied)];
+}
+
+// Get the squares attacked by a queen on the given square
+inline Bitboard queenAttacks(const int square, const Bitboard occupied)
+{
+	return bishopAttacks(square, occupied) | rookAttacks(square, occupied);
+}
@@ -1,1675 +1,1738 @@
 #include "Board.h"
 #include "Move.h"
+#include "Zobrist.h"
+#include "Tablebases.h"
 #include <algorithm>
 #include <iostream>
 #include <thread>
+#include <chrono>
+#include <climits>
+#include <cctype>
+#include <sstream>
 
 int getColorIndex(const Piece::Color color)
 {
 	return color == Piece::Color::WHITE ? 0 : 1;
 }
 
+// Get the hash of the given castling rights (one key for every right)
+static uint64_t castlingZobristValue(const int castlingRights)
+{
+	uint64_t value = 0;
+	for (int right = 0; right < 4; right++)
+		if (castlingRights & (1 << right))
+			value ^= zobristKeys.castling[right];
+
+	return value;
+}
+
+// Castling rights kept after a move from or to each square (moving the king or a rook, or capturing a rook on its corner, loses the rights that use it)
+static const int castlingRightsKept[64] =
+{
+	7, 15, 15, 15,  3, 15, 15, 11,
+	15, 15, 15, 15, 15, 15, 15, 15,
+	15, 15, 15, 15, 15, 15, 15, 15,
+	15, 15, 15, 15, 15, 15, 15, 15,
+	15, 15, 15, 15, 15, 15, 15, 15,
+	15, 15, 15, 15, 15, 15, 15, 15,
+	15, 15, 15, 15, 15, 15, 15, 15,
+	13, 15, 15, 15, 12, 15, 15, 14
+};
+
+const char* const Board::startingFen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
 Board::Board()
 {
-	// Add pawns
-	for (int j = 0; j < 8; j++)
+	this->transpositionTable = std::shared_ptr<TranspositionTable>(new TranspositionTable(defaultTranspositionTableSize));
+	this->searchController = std::make_shared<SearchController>();
+	this->tablebases = std::make_shared<Tablebases>();
+	this->searchStopped = false;
+	this->pendingNodes = 0;
+	this->threadCount = 1;
+
+	this->loadFen(startingFen);
+}
+
+// Get the piece type written with the given FEN letter (uppercase for white and lowercase for black)
+static Piece::Type fenPieceType(const char letter)
+{
+	switch (tolower(letter))
 	{
-		// Black
-		this->board[1][j] = Piece(Piece::Type::PAWN, Piece::Color::BLACK, Position(1, j), false);
+	case 'p':
+		return Piece::Type::PAWN;
+	case 'b':
+		return Piece::Type::BISHOP;
+	case 'n':
+		return Piece::Type::KNIGHT;
+	case 'r':
+		return Piece::Type::ROOK;
+	case 'q':
+		return Piece::Type::QUEEN;
+	case 'k':
+		return Piece::Type::KING;
+	default:
+		return Piece::Type::NONE;
+	}
+}
+
+// Get the FEN letter of a piece (uppercase for white and lowercase for black)
+static char fenLetter(const Piece piece)
+{
+	const char letters[7] = { ' ', 'p', 'b', 'n', 'r', 'q', 'k' };
+	char letter = letters[piece.getType()];
+	return piece.getColor() == Piece::Color::WHITE ? (char)toupper(letter) : letter;
+}
+
+bool Board::loadFen(const std::string& fen)
+{
+	std::istringstream fields(fen);
+	std::string placement, side, castling = "-", enPassant = "-";
+	int halfmoves = 0, fullmoves = 1;
+
+	if (!(fields >> placement >> side))
+		return false;
 
-		// White
-		this->board[6][j] = Piece(Piece::Type::PAWN, Piece::Color::WHITE, Position(6, j), false);
+	// The castling rights, en passant square and move counters can be left out
+	fields >> castling >> enPassant;
+	if (!(fields >> halfmoves))
+		halfmoves = 0;
+	if (!(fields >> fullmoves))
+		fullmoves = 1;
+
+	// Read the pieces of every row starting from the eighth rank (row 0)
+	Piece pieces[64];
+	int row = 0, column = 0;
+	for (char character : placement)
+	{
+		if (character == '/')
+		{
+			if (column != 8)
+				return false;
+			row++;
+			column = 0;
+		}
+		else if ('1' <= character && character <= '8')
+		{
+			column += character - '0';
+		}
+		else
+		{
+			// Pawns can never stand on the first or the last rank
+			Piece::Type type = fenPieceType(character);
+			if (type == Piece::Type::NONE || row >= 8 || column >= 8 || (type == Piece::Type::PAWN && (row == 0 || row == 7)))
+				return false;
+
+			Piece::Color color = isupper(character) ? Piece::Color::WHITE : Piece::Color::BLACK;
+			pieces[squareIndex(row, column)] = Piece(type, color);
+			column++;
+		}
+
+		if (column > 8)
+			return false;
 	}
 
-	// Add black rooks
-	this->board[0][0] = Piece(Piece::Type::ROOK, Piece::Color::BLACK, Position(0, 0), false);
+	if (row != 7 || column != 8 || (side != "w" && side != "b"))
+		return false;
 
-	this->board[0][7] = Piece(Piece::Type::ROOK, Piece::Color::BLACK, Position(0, 7), false);
+	// Each player needs exactly one king
+	int kingCount[2] = { 0, 0 };
+	for (const Piece piece : pieces)
+		if (piece.getType() == Piece::Type::KING)
+			kingCount[getColorIndex(piece.getColor())]++;
 
-	// Add white rooks
-	this->board[7][0] = Piece(Piece::Type::ROOK, Piece::Color::WHITE, Position(7, 0), false);
-	this->board[7][7] = Piece(Piece::Type::ROOK, Piece::Color::WHITE, Position(7, 7), false);
+	if (kingCount[0] != 1 || kingCount[1] != 1)
+		return false;
 
-	// Add black knights
-	this->board[0][1] = Piece(Piece::Type::KNIGHT, Piece::Color::BLACK, Position(0, 1), false);
-	this->board[0][6] = Piece(Piece::Type::KNIGHT, Piece::Color::BLACK, Position(0, 6), false);
+	// A castling right is only kept if the king and the rook it uses are still on their starting squares
+	int rights = 0;
+	for (int right = 0; right < 4; right++)
+	{
+		if (castling.find("KQkq"[right]) == std::string::npos)
+			continue;
 
-	// Add white knights
-	this->board[7][1] = Piece(Piece::Type::KNIGHT, Piece::Color::WHITE, Position(7, 1), false);
-	this->board[7][6] = Piece(Piece::Type::KNIGHT, Piece::Color::WHITE, Position(7, 6), false);
+		Piece::Color color = right < 2 ? Piece::Color::WHITE : Piece::Color::BLACK;
+		int homeRow = right < 2 ? 7 : 0;
+		bool kingAtHome = pieces[squareIndex(homeRow, 4)] == Piece(Piece::Type::KING, color);
+		bool rookAtHome = pieces[squareIndex(homeRow, right % 2 == 0 ? 7 : 0)] == Piece(Piece::Type::ROOK, color);
 
-	// Add black bishops
-	this->board[0][2] = Piece(Piece::Type::BISHOP, Piece::Color::BLACK, Position(0, 2), false);
-	this->board[0][5] = Piece(Piece::Type::BISHOP, Piece::Color::BLACK, Position(0, 5), false);
+		if (kingAtHome && rookAtHome)
+			rights |= 1 << right;
+	}
 
-	// Add white bishops
-	this->board[7][2] = Piece(Piece::Type::BISHOP, Piece::Color::WHITE, Position(7, 2), false);
-	this->board[7][5] = Piece(Piece::Type::BISHOP, Piece::Color::WHITE, Position(7, 5), false);
+	// The FEN is valid so the board can be replaced
+	for (int pieceType = 0; pieceType < 7; pieceType++)
+		this->pieceBitboards[pieceType] = 0;
+
+	this->colorBitboards[0] = 0;
+	this->colorBitboards[1] = 0;
+	std::fill(this->mailbox, this->mailbox + 64, Piece());
+	this->castling = rights;
+	this->middlegameEvaluation = 0;
+	this->endgameEvaluation = 0;
+	this->gamePhase = 0;
+	this->zobristHash = 0;
+	this->pawnHash = 0;
+	this->historySize = 0;
+	if (this->network)
+		this->network->resetAccumulator(this->accumulators[0]);
 
-	// Add black queen
-	this->board[0][3] = Piece(Piece::Type::QUEEN, Piece::Color::BLACK, Position(0, 3), false);
+	for (Square square = 0; square < 64; square++)
+	{
+		if (pieces[square].getType() == Piece::Type::NONE)
+			continue;
 
-	// Add white queen
-	this->board[7][3] = Piece(Piece::Type::QUEEN, Piece::Color::WHITE, Position(7, 3), false);
+		this->addPiece(pieces[square], square);
+		this->applyChangeToZobristHash(pieces[square], square);
+	}
 
-	// Add black king
-	this->board[0][4] = Piece(Piece::Type::KING, Piece::Color::BLACK, Position(0, 4), false);
-	this->blackKingPosition = Position(0, 4);
+	this->sideToMove = Piece::Color::WHITE;
+	if (side == "b")
+		this->passTheTurn();
 
-	// Add white king
-	this->board[7][4] = Piece(Piece::Type::KING, Piece::Color::WHITE, Position(7, 4), false);
-	this->whiteKingPosition = Position(7, 4);
+	// The en passant square has to be on the row a pawn of the other player just passed over
+	this->enPassantSquare = -1;
+	if (enPassant.size() == 2 && 'a' <= enPassant[0] && enPassant[0] <= 'h' && enPassant[1] == (side == "w" ? '6' : '3'))
+		this->enPassantSquare = squareIndex('8' - enPassant[1], enPassant[0] - 'a');
 
-	// Add remaining empty squares
-	for (int i = 2; i <= 5; i++)
-		for (int j = 0; j < 8; j++)
-			this->board[i][j] = Piece(Piece::Type::NONE, Piece::Color::UNCOLORED, Position(i, j), false);
+	this->zobristHash ^= castlingZobristValue(this->castling);
+	if (this->enPassantSquare != -1)
+		this->zobristHash ^= zobristKeys.enPassant[this->enPassantSquare & 7];
 
-	// Store all occupied positions
-	for (int i = 0; i < 8; i++)
-		for (int j = 0; j < 8; j++)
+	this->halfmoveClock = halfmoves;
+	this->fullmoveNumber = fullmoves;
+
+	this->bestMoveForPreviousDepth = Move();
+	this->rootHistorySize = 0;
+
+	return true;
+}
+
+std::string Board::getFen() const
+{
+	std::string fen;
+
+	for (int row = 0; row < 8; row++)
+	{
+		int emptySquares = 0;
+		for (int column = 0; column < 8; column++)
 		{
-			Piece piece = this->board[i][j];
-			if (piece.getType() != Piece::Type::NONE)
+			Piece piece = this->getPiece(squareIndex(row, column));
+			if (piece.getType() == Piece::Type::NONE)
 			{
-				int index = getColorIndex(piece.getColor());
-				this->occupiedSquares[index].insert(this->board[i][j].getPosition());
+				emptySquares++;
+				continue;
 			}
+
+			if (emptySquares > 0)
+				fen += (char)('0' + emptySquares);
+			emptySquares = 0;
+			fen += fenLetter(piece);
 		}
-	
-	this->evaluation = 0;
 
-	srand(time(NULL));
+		if (emptySquares > 0)
+			fen += (char)('0' + emptySquares);
+		if (row < 7)
+			fen += '/';
+	}
 
-	for (int colorIndex = 0; colorIndex < 2; colorIndex++)
-		for (int pieceType = 0; pieceType < 7; pieceType++)
-			for (int row = 0; row < 8; row++)
-				for (int column = 0; column < 8; column++)
-					zobristValues[colorIndex][pieceType][row][column] = ((uint64_t)rand() << 32) | rand();
+	fen += this->sideToMove == Piece::Color::WHITE ? " w " : " b ";
 
-	this->blackToMoveZobristValue = ((uint64_t)rand() << 32) | rand();
+	std::string castling;
+	int rights = this->castlingRights();
+	for (int right = 0; right < 4; right++)
+		if (rights & (1 << right))
+			castling += "KQkq"[right];
+	fen += castling.empty() ? "-" : castling;
 
-	this->zobristHash = 0;
+	fen += ' ';
+	if (this->enPassantSquare == -1)
+	{
+		fen += '-';
+	}
+	else
+	{
+		fen += (char)('a' + (this->enPassantSquare & 7));
+		fen += (char)('8' - (this->enPassantSquare >> 3));
+	}
 
-	for (int i = 0; i < 8; i++)
-		for (int j = 0; j < 8; j++)
-			if (this->board[i][j].getType() != Piece::Type::NONE)
-				this->zobristHash = this->zobristHash ^ this->zobristValues[getColorIndex(this->board[i][j].getColor())][this->board[i][j].getType()][i][j];
+	fen += " " + std::to_string(this->halfmoveClock) + " " + std::to_string(this->fullmoveNumber);
 
-	this->transpositionTable.resize(transpositionTableSize);
+	return fen;
 }
 
-Piece Board::getPiece(const Position position) const
+bool Board::hasRoomForGameMove() const
 {
-	return this->board[position.row()][position.column()];
+	return this->historySize < maxHistorySize - searchHistoryReserve;
 }
 
-// Check if a position is on the board given its coordinates
-bool validPosition(const int row, const int column)
+void Board::clearHistory()
 {
-	return 0 <= row && row < 8 && 0 <= column && column < 8;
+	// The FEN keeps everything the moves left on the board (castling rights, en passant square and move counters)
+	this->loadFen(this->getFen());
 }
 
-// Check if a given position is on the board
-bool validPosition(const Position position)
+Piece::Color Board::getPlayerToMove() const
 {
-	return 0 <= position.row() && position.row() < 8 && 0 <= position.column() && position.column() < 8;
+	return this->sideToMove;
 }
 
-bool Board::availableSquare(const Piece::Color color, const int row, const int column) const
+Piece Board::getPiece(const Square square) const
 {
-	if (!validPosition(row, column)) // Return false if the position is out of the board
-		return false;
-
-	Piece square = this->board[row][column];
-
-	if (square.getType() == Piece::Type::NONE) // Return true if the square is empty
-		return true;
-
-	if (square.getType() == Piece::Type::KING) // Return false if there is a king on the square
-		return false;
+	return this->mailbox[square];
+}
 
-	if (square.getColor() != color) // Return true if the square is not empty but the piece that is on the square is of the other color and is not a king
-		return true;
+Bitboard Board::getPieces(const Piece::Type type, const Piece::Color color) const
+{
+	return this->pieceBitboards[type] & this->colorBitboards[getColorIndex(color)];
+}
 
-	return false;
+int Board::getEnPassantSquare() const
+{
+	return this->enPassantSquare;
 }
 
-void Board::addAllMovesInDirection(std::vector<Move>& moves, const Piece piece, const int rowChange, const int columnChange) const
+int Board::castlingRights() const
 {
-	Position position = piece.getPosition();
-	while (true) // Loop until finding a stop condition
-	{
-		position.GoTowards(rowChange, columnChange); // Go in the given direction
-		if (!validPosition(position)) // Stop if we get out of the board
-			return;
+	return this->castling;
+}
 
-		Piece square = this->board[position.row()][position.column()]; // Get the current square
+int Board::getPieceCount() const
+{
+	return popCount(this->occupiedSquares());
+}
 
-		if (square.getType() != Piece::Type::NONE)
-		{
-			if (square.getColor() != piece.getColor() && square.getType() != Piece::Type::KING) // If the other piece is not the same color and is not a king then we can capture it
-				moves.push_back(Move(piece.getPosition(), position));
+int Board::getHalfmoveClock() const
+{
+	return this->halfmoveClock;
+}
 
-			return; // If we found another piece we must stop regardless of color or type
-		}
+Bitboard Board::occupiedSquares() const
+{
+	return this->colorBitboards[0] | this->colorBitboards[1];
+}
 
-		// If the square is empty then we can move there
-		moves.push_back(Move(piece.getPosition(), position));
-	}
+Square Board::kingSquare(const Piece::Color color) const
+{
+	return leastSignificantSquare(this->pieceBitboards[Piece::Type::KING] & this->colorBitboards[getColorIndex(color)]);
 }
 
-void Board::addPawnMoves(std::vector<Move>& moves, const Piece piece) const
+void Board::addMovesToTargets(MoveList& moves, const Square initialSquare, Bitboard targets) const
 {
-	int row = piece.getPosition().row();
-	int column = piece.getPosition().column();
+	while (targets)
+		moves.push(Move(initialSquare, popLeastSignificantSquare(targets)));
+}
 
-	if (piece.getColor() == Piece::Color::WHITE)
+// Add a pawn move to a container reference given as a parameter, adding every promotion type if the pawn reaches the last row
+static void addPawnMove(MoveList& moves, const Square initialSquare, const Square targetSquare)
+{
+	if (squareRow(targetSquare) == 0 || squareRow(targetSquare) == 7)
 	{
-		// Go one square up
-		if (validPosition(row - 1, column) && this->board[row - 1][column].getType() == Piece::Type::NONE)
-		{
-			// Check for promotion possibilty
-			if (row - 1 == 0)
-			{
-				moves.push_back(Move(piece.getPosition(), Position(row - 1, column), Piece::Type::QUEEN));
-				moves.push_back(Move(piece.getPosition(), Position(row - 1, column), Piece::Type::ROOK));
-				moves.push_back(Move(piece.getPosition(), Position(row - 1, column), Piece::Type::BISHOP));
-				moves.push_back(Move(piece.getPosition(), Position(row - 1, column), Piece::Type::KNIGHT));
-			}
-			else
-			{
-				moves.push_back(Move(piece.getPosition(), Position(row - 1, column)));
-			}
-
-			// If on first move then go one more square up
-			if (!piece.hasMoved() && validPosition(row - 2, column) && this->board[row - 2][column].getType() == Piece::Type::NONE)
-				moves.push_back(Move(piece.getPosition(), Position(row - 2, column)));
-		}
-
-		if (validPosition(row - 1, column - 1))
-		{
-			// Capture black piece up-left
-			if (this->board[row - 1][column - 1].getType() != Piece::Type::NONE && this->board[row - 1][column - 1].getType() != Piece::Type::KING)
-				if (this->board[row - 1][column - 1].getColor() != piece.getColor())
-				{
-					// Check for promotion possibilty
-					if (row - 1 == 0)
-					{
-						moves.push_back(Move(piece.getPosition(), Position(row - 1, column - 1), Piece::Type::QUEEN));
-						moves.push_back(Move(piece.getPosition(), Position(row - 1, column - 1), Piece::Type::ROOK));
-						moves.push_back(Move(piece.getPosition(), Position(row - 1, column - 1), Piece::Type::BISHOP));
-						moves.push_back(Move(piece.getPosition(), Position(row - 1, column - 1), Piece::Type::KNIGHT));
-					}
-					else
-					{
-						moves.push_back(Move(piece.getPosition(), Position(row - 1, column - 1)));
-					}
-				}
-
-			// En passant
-			if (row == 3)
-			{
-				Piece lastRemovedPiece = this->removedPieces.top();
-				Piece lastAddedPiece = this->addedPieces.top();
-
-				if (lastRemovedPiece.getType() == Piece::Type::PAWN && lastAddedPiece.getType() == Piece::Type::PAWN) // Check if the last moved piece is a pawn
-					if (!lastRemovedPiece.hasMoved() && lastAddedPiece.getPosition() == Position(row, column - 1)) // Check if the pawn moved 2 pieces forward
-						moves.push_back(Move(piece.getPosition(), Position(row - 1, column - 1)));
-			}
-		}
-
-		
-		if (validPosition(row - 1, column + 1))
-		{
-			// Capture black piece up-right
-			if (this->board[row - 1][column + 1].getType() != Piece::Type::NONE && this->board[row - 1][column + 1].getType() != Piece::Type::KING)
-				if (this->board[row - 1][column + 1].getColor() != piece.getColor())
-				{
-					// Check for promotion possibilty
-					if (row - 1 == 0)
-					{
-						moves.push_back(Move(piece.getPosition(), Position(row - 1, column + 1), Piece::Type::QUEEN));
-						moves.push_back(Move(piece.getPosition(), Position(row - 1, column + 1), Piece::Type::ROOK));
-						moves.push_back(Move(piece.getPosition(), Position(row - 1, column + 1), Piece::Type::BISHOP));
-						moves.push_back(Move(piece.getPosition(), Position(row - 1, column + 1), Piece::Type::KNIGHT));
-					}
-					else
-					{
-						moves.push_back(Move(piece.getPosition(), Position(row - 1, column + 1)));
-					}
-				}
-
-			// En passant
-			if (row == 3)
-			{
-				Piece lastRemovedPiece = this->removedPieces.top();
-				Piece lastAddedPiece = this->addedPieces.top();
-
-				if (lastRemovedPiece.getType() == Piece::Type::PAWN && lastAddedPiece.getType() == Piece::Type::PAWN) // Check if the last moved piece is a pawn
-					if (!lastRemovedPiece.hasMoved() && lastAddedPiece.getPosition() == Position(row, column + 1)) // Check if the pawn moved 2 pieces forward
-						moves.push_back(Move(piece.getPosition(), Position(row - 1, column + 1)));
-			}
-		}
+		moves.push(Move(initialSquare, targetSquare, Piece::Type::QUEEN));
+		moves.push(Move(initialSquare, targetSquare, Piece::Type::ROOK));
+		moves.push(Move(initialSquare, targetSquare, Piece::Type::BISHOP));
+		moves.push(Move(initialSquare, targetSquare, Piece::Type::KNIGHT));
 	}
 	else
 	{
-		// Go one square down
-		if (validPosition(row + 1, column) && this->board[row + 1][column].getType() == Piece::Type::NONE)
-		{
-			// Check for promotion possibilty
-			if (row + 1 == 7)
-			{
-				moves.push_back(Move(piece.getPosition(), Position(row + 1, column), Piece::Type::QUEEN));
-				moves.push_back(Move(piece.getPosition(), Position(row + 1, column), Piece::Type::ROOK));
-				moves.push_back(Move(piece.getPosition(), Position(row + 1, column), Piece::Type::BISHOP));
-				moves.push_back(Move(piece.getPosition(), Position(row + 1, column), Piece::Type::KNIGHT));
-			}
-			else
-			{
-				moves.push_back(Move(piece.getPosition(), Position(row + 1, column)));
-			}
+		moves.push(Move(initialSquare, targetSquare));
+	}
+}
 
-			// If on first move then go one more square down
-			if (!piece.hasMoved() && validPosition(row + 2, column) && this->board[row + 2][column].getType() == Piece::Type::NONE)
-				moves.push_back(Move(piece.getPosition(), Position(row + 2, column)));
-		}
+void Board::addPawnMoves(MoveList& moves, const Square square, const Piece::Color color, const bool capturesOnly) const
+{
+	int row = squareRow(square);
+	int colorIndex = getColorIndex(color);
 
-		if (validPosition(row + 1, column - 1))
-		{
-			// Capture white piece down-left
-			if (this->board[row + 1][column - 1].getType() != Piece::Type::NONE && this->board[row + 1][column - 1].getType() != Piece::Type::KING)
-				if (this->board[row + 1][column - 1].getColor() != piece.getColor())
-				{
-					// Check for promotion possibilty
-					if (row + 1 == 7)
-					{
-						moves.push_back(Move(piece.getPosition(), Position(row + 1, column - 1), Piece::Type::QUEEN));
-						moves.push_back(Move(piece.getPosition(), Position(row + 1, column - 1), Piece::Type::ROOK));
-						moves.push_back(Move(piece.getPosition(), Position(row + 1, column - 1), Piece::Type::BISHOP));
-						moves.push_back(Move(piece.getPosition(), Position(row + 1, column - 1), Piece::Type::KNIGHT));
-					}
-					else
-					{
-						moves.push_back(Move(piece.getPosition(), Position(row + 1, column - 1)));
-					}
-				}
-
-			// En passant
-			if (row == 4)
-			{
-				Piece lastRemovedPiece = this->removedPieces.top();
-				Piece lastAddedPiece = this->addedPieces.top();
+	// White pawns go up the board and black pawns go down (a pawn is never on the last row so the squares in front of it are on the board)
+	Direction forward = color == Piece::Color::WHITE ? Direction::UP : Direction::DOWN;
+	Square oneStep = shiftSquare(square, forward);
+	Bitboard occupied = this->occupiedSquares();
 
-				if (lastRemovedPiece.getType() == Piece::Type::PAWN && lastAddedPiece.getType() == Piece::Type::PAWN) // Check if the last moved piece is a pawn
-					if (!lastRemovedPiece.hasMoved() && lastAddedPiece.getPosition() == Position(row, column - 1)) // Check if the pawn moved 2 pieces forward
-						moves.push_back(Move(piece.getPosition(), Position(row + 1, column - 1)));
-			}
-		}
+	// Go one square forward (a push is only a promotion if it reaches the last row)
+	bool promotes = squareRow(oneStep) == 0 || squareRow(oneStep) == 7;
+	if (!(occupied & squareBitboard(oneStep)) && (!capturesOnly || promotes))
+	{
+		addPawnMove(moves, square, oneStep);
 
-		if (validPosition(row + 1, column + 1))
-		{
-			// Capture white piece down-right
-			if (this->board[row + 1][column + 1].getType() != Piece::Type::NONE && this->board[row + 1][column + 1].getType() != Piece::Type::KING)
-				if (this->board[row + 1][column + 1].getColor() != piece.getColor())
-				{
-					// Check for promotion possibilty
-					if (row + 1 == 7)
-					{
-						moves.push_back(Move(piece.getPosition(), Position(row + 1, column + 1), Piece::Type::QUEEN));
-						moves.push_back(Move(piece.getPosition(), Position(row + 1, column + 1), Piece::Type::ROOK));
-						moves.push_back(Move(piece.getPosition(), Position(row + 1, column + 1), Piece::Type::BISHOP));
-						moves.push_back(Move(piece.getPosition(), Position(row + 1, column + 1), Piece::Type::KNIGHT));
-					}
-					else
-					{
-						moves.push_back(Move(piece.getPosition(), Position(row + 1, column + 1)));
-					}
-				}
-
-			// En passant
-			if (row == 4)
-			{
-				Piece lastRemovedPiece = this->removedPieces.top();
-				Piece lastAddedPiece = this->addedPieces.top();
+		// If still on its starting row then go one more square forward
+		Square twoSteps = shiftSquare(oneStep, forward);
+		if (!capturesOnly && row == (color == Piece::Color::WHITE ? 6 : 1) && !(occupied & squareBitboard(twoSteps)))
+			moves.push(Move(square, twoSteps));
+	}
 
-				if (lastRemovedPiece.getType() == Piece::Type::PAWN && lastAddedPiece.getType() == Piece::Type::PAWN) // Check if the last moved piece is a pawn
-					if (!lastRemovedPiece.hasMoved() && lastAddedPiece.getPosition() == Position(row, column + 1)) // Check if the pawn moved 2 pieces forward
-						moves.push_back(Move(piece.getPosition(), Position(row + 1, column + 1)));
-			}
-		}
+	// Capture pieces of the other color diagonally
+	Bitboard captures = pawnAttacks[colorIndex][square] & this->colorBitboards[1 - colorIndex] & ~this->pieceBitboards[Piece::Type::KING];
+	while (captures)
+		addPawnMove(moves, square, popLeastSignificantSquare(captures));
+
+	// En passant (a white pawn can only capture en passant from row 3 and a black pawn from row 4)
+	if (row == (color == Piece::Color::WHITE ? 3 : 4) && this->enPassantSquare != -1)
+	{
+		// Check if the last moved pawn passed over a square attacked by this pawn
+		if (pawnAttacks[colorIndex][square] & squareBitboard(this->enPassantSquare))
+			moves.push(Move(square, this->enPassantSquare, Move::Flag::EN_PASSANT));
 	}
 }
 
-void Board::addBishopMoves(std::vector<Move>& moves, const Piece piece) const
+void Board::addBishopMoves(MoveList& moves, const Square square, const Piece::Color color, const bool capturesOnly) const
 {
-	// Get all moves in the up-left direction
-	this->addAllMovesInDirection(moves, piece, -1, -1);
-	
-	// Get all moves in the up-right direction
-	this->addAllMovesInDirection(moves, piece, -1, 1);
-
-	// Get all moves in the down-left direction
-	this->addAllMovesInDirection(moves, piece, 1, -1);
-
-	// Get all moves in the down-right direction
-	this->addAllMovesInDirection(moves, piece, 1, 1);
+	// The bishop can move on every attacked square that is empty or holds a piece of the other color that is not a king
+	Bitboard blocked = this->colorBitboards[getColorIndex(color)] | this->pieceBitboards[Piece::Type::KING];
+	if (capturesOnly)
+		blocked |= ~this->occupiedSquares();
+	this->addMovesToTargets(moves, square, bishopAttacks(square, this->occupiedSquares()) & ~blocked);
 }
 
-void Board::addKnightMoves(std::vector<Move>& moves, const Piece piece) const
+void Board::addKnightMoves(MoveList& moves, const Square square, const Piece::Color color, const bool capturesOnly) const
 {
-	int row = piece.getPosition().row();
-	int column = piece.getPosition().column();
-
-	// Check squares in the up-left direction
-	if (this->availableSquare(piece.getColor(), row - 1, column - 2))
-		moves.push_back(Move(piece.getPosition(), Position(row - 1, column - 2)));
-
-	if (this->availableSquare(piece.getColor(), row - 2, column - 1))
-		moves.push_back(Move(piece.getPosition(), Position(row - 2, column - 1)));
-
-	// Check squares in the up-right direction
-	if (this->availableSquare(piece.getColor(), row - 2, column + 1))
-		moves.push_back(Move(piece.getPosition(), Position(row - 2, column + 1)));
-
-	if (this->availableSquare(piece.getColor(), row - 1, column + 2))
-		moves.push_back(Move(piece.getPosition(), Position(row - 1, column + 2)));
-
-	// Check squares in the down-left direction
-	if (this->availableSquare(piece.getColor(), row + 1, column - 2))
-		moves.push_back(Move(piece.getPosition(), Position(row + 1, column - 2)));
-
-	if (this->availableSquare(piece.getColor(), row + 2, column - 1))
-		moves.push_back(Move(piece.getPosition(), Position(row + 2, column - 1)));
-
-	// Check squares in the down-right direction
-	if (this->availableSquare(piece.getColor(), row + 2, column + 1))
-		moves.push_back(Move(piece.getPosition(), Position(row + 2, column + 1)));
-
-	if (this->availableSquare(piece.getColor(), row + 1, column + 2))
-		moves.push_back(Move(piece.getPosition(), Position(row + 1, column + 2)));
+	// The knight can move on every attacked square that is empty or holds a piece of the other color that is not a king
+	Bitboard blocked = this->colorBitboards[getColorIndex(color)] | this->pieceBitboards[Piece::Type::KING];
+	if (capturesOnly)
+		blocked |= ~this->occupiedSquares();
+	this->addMovesToTargets(moves, square, knightAttacks[square] & ~blocked);
 }
 
-void Board::addRookMoves(std::vector<Move>& moves, const Piece piece) const
+void Board::addRookMoves(MoveList& moves, const Square square, const Piece::Color color, const bool capturesOnly) const
 {
-	// Get all moves in the up direction
-	this->addAllMovesInDirection(moves, piece, -1, 0);
-
-	// Get all moves in the down direction
-	this->addAllMovesInDirection(moves, piece, 1, 0);
-
-	// Get all moves in the left direction
-	this->addAllMovesInDirection(moves, piece, 0, -1);
-
-	// Get all moves in the right direction
-	this->addAllMovesInDirection(moves, piece, 0, 1);
+	// The rook can move on every attacked square that is empty or holds a piece of the other color that is not a king
+	Bitboard blocked = this->colorBitboards[getColorIndex(color)] | this->pieceBitboards[Piece::Type::KING];
+	if (capturesOnly)
+		blocked |= ~this->occupiedSquares();
+	this->addMovesToTargets(moves, square, rookAttacks(square, this->occupiedSquares()) & ~blocked);
 }
 
-void Board::addQueenMoves(std::vector<Move>& moves, const Piece piece) const
+void Board::addQueenMoves(MoveList& moves, const Square square, const Piece::Color color, const bool capturesOnly) const
 {
 	// The queen can move in every square that a rook and a bishop can move
-	this->addRookMoves(moves, piece);
-	this->addBishopMoves(moves, piece);
+	Bitboard blocked = this->colorBitboards[getColorIndex(color)] | this->pieceBitboards[Piece::Type::KING];
+	if (capturesOnly)
+		blocked |= ~this->occupiedSquares();
+	this->addMovesToTargets(moves, square, queenAttacks(square, this->occupiedSquares()) & ~blocked);
 }
 
-void Board::addKingMoves(std::vector<Move>& moves, const Piece piece) const
+void Board::addKingMoves(MoveList& moves, const Square square, const Piece::Color color, const bool capturesOnly) const
 {
-	int row = piece.getPosition().row();
-	int column = piece.getPosition().column();
+	int row = squareRow(square);
+	int column = squareColumn(square);
+	int colorIndex = getColorIndex(color);
 
 	// Check all position surrounding the king
-	for (int i = row - 1; i <= row + 1; i++)
-		for (int j = column - 1; j <= column + 1; j++)
-			if (i != row || j != column) // Check if the square we try to make the move on is not the current one
-				if (this->availableSquare(piece.getColor(), i, j))
-					moves.push_back(Move(piece.getPosition(), Position(i, j)));
-
-	// Check if the king has moved
-	if (!piece.hasMoved())
+	Bitboard blocked = this->colorBitboards[colorIndex] | this->pieceBitboards[Piece::Type::KING];
+	if (capturesOnly)
+		blocked |= ~this->occupiedSquares();
+	this->addMovesToTargets(moves, square, kingAttacks[square] & ~blocked);
+
+	// The castling rights of the color (castling is never a capture), a right is only kept while the king and the rook it uses are on their starting squares
+	int kingsideRight = 1 << (2 * colorIndex);
+	int queensideRight = 2 << (2 * colorIndex);
+	if ((this->castling & (kingsideRight | queensideRight)) && !capturesOnly)
 	{
 		// Get the color opposing the color of the king
-		auto otherColor = piece.getColor() == Piece::Color::WHITE ? Piece::Color::BLACK : Piece::Color::WHITE;
-		
-		// Check if the queenside rook has moved
-		Piece possibleRook = this->getPiece(Position(row, 0));
-		if (possibleRook.getType() == Piece::Type::ROOK && !possibleRook.hasMoved())
+		auto otherColor = color == Piece::Color::WHITE ? Piece::Color::BLACK : Piece::Color::WHITE;
+
+		Bitboard occupied = this->occupiedSquares();
+
+		// Check if the player can still castle queenside
+		if (this->castling & queensideRight)
 		{
 			bool canCastle = true;
 
 			// Check if the square between the king and the rook are empty
 			for (int columnToCheck = 1; columnToCheck < column && canCastle; columnToCheck++)
-				if (this->board[row][columnToCheck].getType() != Piece::Type::NONE)
+				if (occupied & squareBitboard(squareIndex(row, columnToCheck)))
 					canCastle = false;
 
 			// Check if the squares the king would travel are attacked by the other color
 			for (int columnToCheck = column - 2; columnToCheck <= column && canCastle; columnToCheck++)
-				if (this->isAttackedBy(Position(row, columnToCheck), otherColor))
+				if (this->isAttackedBy(squareIndex(row, columnToCheck), otherColor))
 					canCastle = false;
-					
-					
+
+
 			if (canCastle)
 			{
-				moves.push_back(Move(piece.getPosition(), Position(row, column - 2)));
+				moves.push(Move(square, squareIndex(row, column - 2), Move::Flag::CASTLING));
 			}
 		}
 
-		// Check if the kingside rook has moved
-		possibleRook = this->getPiece(Position(row, 7));
-		if (possibleRook.getType() == Piece::Type::ROOK && !possibleRook.hasMoved())
+		// Check if the player can still castle kingside
+		if (this->castling & kingsideRight)
 		{
 			bool canCastle = true;
 
 			// Check if the square between the king and the rook are empty
 			for (int columnToCheck = column + 1; columnToCheck < 7 && canCastle; columnToCheck++)
-				if (this->board[row][columnToCheck].getType() != Piece::Type::NONE)
+				if (occupied & squareBitboard(squareIndex(row, columnToCheck)))
 					canCastle = false;
 
 			// Check if the squares the king would travel are attacked by the other color
 			for (int columnToCheck = column; columnToCheck <= column + 2 && canCastle; columnToCheck++)
-				if (this->isAttackedBy(Position(row, columnToCheck), otherColor))
+				if (this->isAttackedBy(squareIndex(row, columnToCheck), otherColor))
 					canCastle = false;
-					
+
 
 			if (canCastle)
 			{
-				moves.push_back(Move(piece.getPosition(), Position(row, column + 2)));
+				moves.push(Move(square, squareIndex(row, column + 2), Move::Flag::CASTLING));
 			}
 		}
 	}
 }
 
-void Board::addPiece(const Piece piece, const bool silent)
+void Board::addPiece(const Piece piece, const Square square)
 {
-	// Only mark changes on the helper stacks if silent is false
-	if (!silent)
-	{
-		this->actionsMade.push(Action::ADD_PIECE); // Mark adding a piece on the board
-		this->addedPieces.push(piece);
-	}
-
-	Position position = piece.getPosition();
-	this->board[position.row()][position.column()] = piece; // Store the piece on the board
-
-	// Mark the piece position as occupied by the piece color
-	int colorIndex = getColorIndex(piece.getColor());
-	this->occupiedSquares[colorIndex].insert(position);
+	Bitboard squareMask = squareBitboard(square);
 
-	// If the added piece is a king then update its stored position
-	if (piece.getType() == Piece::Type::KING)
-	{
-		if (piece.getColor() == Piece::Color::WHITE)
-			this->whiteKingPosition = position;
-		else
-			this->blackKingPosition = position;
-	}
+	// Mark the square as occupied by the piece type and color
+	this->pieceBitboards[piece.getType()] |= squareMask;
+	this->colorBitboards[getColorIndex(piece.getColor())] |= squareMask;
+	this->mailbox[square] = piece;
 
-	// Compute and add value corresponding to the piece to board evaluation
-	int squareValue = pieceValue[piece.getType()];
+	this->updateEvaluation(piece, square, 1);
+}
 
-	if (piece.getColor() == Piece::Color::BLACK)
-	{
-		// The position value table must be inverted for black pieces
-		squareValue += positionValue[piece.getType()][7 - position.row()][position.column()];
+void Board::removePiece(const Square square)
+{
+	Piece piece = this->mailbox[square];
+	Bitboard squareMask = squareBitboard(square);
 
-		// The value of the square is negative for black pieces
-		squareValue = -squareValue;
-	}
-	else
-	{
-		// Simply add the positional value for a white piece
-		squareValue += positionValue[piece.getType()][position.row()][position.column()];
-	}
+	// Empty the board square
+	this->pieceBitboards[piece.getType()] &= ~squareMask;
+	this->colorBitboards[getColorIndex(piece.getColor())] &= ~squareMask;
+	this->mailbox[square] = Piece();
 
-	this->evaluation += squareValue;
+	this->updateEvaluation(piece, square, -1);
 }
 
-void Board::removePiece(const Piece piece, const bool silent)
+void Board::updateEvaluation(const Piece piece, const Square square, const int sign)
 {
-	// Only mark changes on the helper stacks if silent is false
-	if (!silent)
-	{
-		this->actionsMade.push(Action::REMOVE_PIECE); // Mark the removal of a piece
-		this->removedPieces.push(piece); // Store the removed piece on a separate stack
-	}
+	Piece::Type type = piece.getType();
 
-	Position position = piece.getPosition();
-	this->board[position.row()][position.column()] = Piece(position); // Empty the board square
+	// The position value tables must be inverted for black pieces
+	Square tableSquare = piece.getColor() == Piece::Color::BLACK ? mirrorSquare(square) : square;
 
-	// Unmark the previously occupied square
-	int colorIndex = getColorIndex(piece.getColor());
-	this->occupiedSquares[colorIndex].erase(position);
-
-	// Compute and subtract value corresponding to the piece to board evaluation
-	int squareValue = pieceValue[piece.getType()];
+	// Only the king has a different table for the end game
+	int middlegameValue = pieceValue[type] + positionValue[type][tableSquare];
+	int endgameValue = pieceValue[type] + positionValue[type == Piece::Type::KING ? 7 : type][tableSquare];
 
-	if (piece.getColor() == Piece::Color::BLACK)
-	{
-		// The position value table must be inverted for black pieces
-		squareValue += positionValue[piece.getType()][7 - position.row()][position.column()];
+	// The values are negative for black pieces
+	int colorSign = piece.getColor() == Piece::Color::BLACK ? -sign : sign;
+	this->middlegameEvaluation += colorSign * middlegameValue;
+	this->endgameEvaluation += colorSign * endgameValue;
+	this->gamePhase += sign * gamePhaseWeight[type];
 
-		// The value of the square is negative for black pieces
-		squareValue = -squareValue;
-	}
-	else
-	{
-		// Simply add the positional value for a white piece
-		squareValue += positionValue[piece.getType()][position.row()][position.column()];
-	}
+	// The hidden layer of the network follows the same changes
+	if (this->network)
+		this->network->updateAccumulator(this->accumulators[this->historySize], piece, square, sign);
+}
 
-	this->evaluation -= squareValue;
+void Board::togglePiece(const Piece::Type type, const Piece::Color color, const Square square)
+{
+	this->pieceBitboards[type] ^= squareBitboard(square);
+	this->colorBitboards[getColorIndex(color)] ^= squareBitboard(square);
+	this->mailbox[square] = (this->pieceBitboards[type] & squareBitboard(square)) ? Piece(type, color) : Piece();
 }
 
-bool Board::isAttackedBy(const Position position, const Piece::Color attackingColor) const
+bool Board::isAttackedBy(const Square square, const Piece::Color attackingColor) const
 {
-	if (attackingColor == Piece::Color::BLACK)
-	{
-		// Check for a pawn in the up-left direction
-		if (validPosition(position.UpLeft()) && this->getPiece(position.UpLeft()).getType() == Piece::Type::PAWN && this->getPiece(position.UpLeft()).getColor() == attackingColor)
-			return true;
+	int attackingIndex = getColorIndex(attackingColor);
+	Bitboard attackers = this->colorBitboards[attackingIndex];
 
-		// Check for a pawn in the up-right direction
-		if (validPosition(position.UpRight()) && this->getPiece(position.UpRight()).getType() == Piece::Type::PAWN && this->getPiece(position.UpRight()).getColor() == attackingColor)
-			return true;
-	}
-	else
-	{
-		// Check for a pawn in the down-left direction
-		if (validPosition(position.DownLeft()) && this->getPiece(position.DownLeft()).getType() == Piece::Type::PAWN && this->getPiece(position.DownLeft()).getColor() == attackingColor)
-			return true;
+	// Check for pawns (a pawn of the attacking color attacks this square if a pawn of the other color standing here would attack the pawn)
+	if (pawnAttacks[1 - attackingIndex][square] & attackers & this->pieceBitboards[Piece::Type::PAWN])
+		return true;
 
-		// Check for a pawn in the down-right direction
-		if (validPosition(position.DownRight()) && this->getPiece(position.DownRight()).getType() == Piece::Type::PAWN && this->getPiece(position.DownRight()).getColor() == attackingColor)
-			return true;
-	}
+	// Check for knights
+	if (knightAttacks[square] & attackers & this->pieceBitboards[Piece::Type::KNIGHT])
+		return true;
 
-	Position positionToCheck;
+	// Check for kings
+	if (kingAttacks[square] & attackers & this->pieceBitboards[Piece::Type::KING])
+		return true;
 
-	// Check in the up direction
-	positionToCheck = position.Up();
-	while (validPosition(positionToCheck))
-	{
-		Piece::Type pieceType = this->getPiece(positionToCheck).getType();
-		Piece::Color pieceColor = this->getPiece(positionToCheck).getColor();
+	// Check for rooks and queens along rows and columns
+	Bitboard occupied = this->occupiedSquares();
+	if (rookAttacks(square, occupied) & attackers & (this->pieceBitboards[Piece::Type::ROOK] | this->pieceBitboards[Piece::Type::QUEEN]))
+		return true;
 
-		// The first piece we encounter
-		if (pieceType != Piece::Type::NONE)
-		{
-			// If the piece is not of the attacking color then the position can not be attacked from this direction
-			if (pieceColor != attackingColor)
-				break;
+	// Check for bishops and queens along diagonals
+	if (bishopAttacks(square, occupied) & attackers & (this->pieceBitboards[Piece::Type::BISHOP] | this->pieceBitboards[Piece::Type::QUEEN]))
+		return true;
 
-			// If the first piece we encounter is a rook or queen of attacking color then the position is attacked
-			if (pieceType == Piece::Type::ROOK || pieceType == Piece::Type::QUEEN)
-				return true;
-			
-			// If the piece is not a rook or a queen then the position can not be attacked from this direction
-			break;
-		}
+	return false;
+}
 
-		positionToCheck = positionToCheck.Up();
-	}
+bool Board::isInCheck(const Piece::Color color) const
+{
+	Piece::Color otherColor = color == Piece::Color::WHITE ? Piece::Color::BLACK : Piece::Color::WHITE;
+	return this->isAttackedBy(this->kingSquare(color), otherColor);
+}
 
-	// Check in the down direction
-	positionToCheck = position.Down();
-	while (validPosition(positionToCheck))
-	{
-		Piece::Type pieceType = this->getPiece(positionToCheck).getType();
-		Piece::Color pieceColor = this->getPiece(positionToCheck).getColor();
+std::vector<Move> Board::getMoves(const Piece::Color playerColor) const
+{
+	MoveList moves;
+	this->getMoves(playerColor, moves);
 
-		// The first piece we encounter
-		if (pieceType != Piece::Type::NONE)
-		{
-			// If the piece is not of the attacking color then the position can not be attacked from this direction
-			if (pieceColor != attackingColor)
-				break;
+	return std::vector<Move>(moves.begin(), moves.end());
+}
 
-			// If the first piece we encounter is a rook or queen of attacking color then the position is attacked
-			if (pieceType == Piece::Type::ROOK || pieceType == Piece::Type::QUEEN)
-				return true;
+void Board::getMoves(const Piece::Color playerColor, MoveList& moves) const
+{
+	this->generateMoves(playerColor, moves, false);
+}
 
-			// If the piece is not a rook or a queen then the position can not be attacked from this direction
-			break;
-		}
+void Board::getCaptures(const Piece::Color playerColor, MoveList& moves) const
+{
+	this->generateMoves(playerColor, moves, true);
+}
 
-		positionToCheck = positionToCheck.Down();
-	}
+void Board::generateMoves(const Piece::Color playerColor, MoveList& moves, const bool capturesOnly) const
+{
+	int index = getColorIndex(playerColor);
+	Bitboard ownPieces = this->colorBitboards[index];
+	Bitboard enemyPieces = this->colorBitboards[1 - index];
+	Bitboard occupied = ownPieces | enemyPieces;
+	Square king = this->kingSquare(playerColor);
+	moves.clear();
+
+	Bitboard checkers = this->attackersTo(king, occupied) & enemyPieces;
+
+	// The king can only move to squares that are not attacked, it is taken off the board so it can not hide behind itself on the line of a checking slider
+	// (castling moves are only generated when the king does not pass through an attacked square)
+	this->addKingMoves(moves, king, playerColor, capturesOnly);
+
+	int legalCount = 0;
+	for (int i = 0; i < moves.size(); i++)
+		if (moves[i].getFlag() == Move::Flag::CASTLING || !(this->attackersTo(moves[i].getTargetSquare(), occupied ^ squareBitboard(king)) & enemyPieces))
+			moves[legalCount++] = moves[i];
+	moves.truncate(legalCount);
+
+	// In double check only the king can move
+	if (checkers & (checkers - 1))
+		return;
 
-	// Check in the left direction
-	positionToCheck = position.Left();
-	while (validPosition(positionToCheck))
-	{
-		Piece::Type pieceType = this->getPiece(positionToCheck).getType();
-		Piece::Color pieceColor = this->getPiece(positionToCheck).getColor();
+	// In check the other pieces have to capture the checking piece or block its line
+	Bitboard checkMask = checkers ? checkers | betweenSquares[king][leastSignificantSquare(checkers)] : ~0ULL;
 
-		// The first piece we encounter
-		if (pieceType != Piece::Type::NONE)
+	// A piece is pinned if it is the only piece between its king and an enemy slider on the same line, it can only move along that line
+	Bitboard pinnedPieces = 0;
+	Bitboard pinRays[64];
+	Bitboard snipers = enemyPieces & (
+		(rookAttacks(king, 0) & (this->pieceBitboards[Piece::Type::ROOK] | this->pieceBitboards[Piece::Type::QUEEN])) |
+		(bishopAttacks(king, 0) & (this->pieceBitboards[Piece::Type::BISHOP] | this->pieceBitboards[Piece::Type::QUEEN])));
+	while (snipers)
+	{
+		int sniper = popLeastSignificantSquare(snipers);
+		Bitboard blockers = betweenSquares[king][sniper] & occupied;
+		if (blockers && !(blockers & (blockers - 1)) && (blockers & ownPieces))
 		{
-			// If the piece is not of the attacking color then the position can not be attacked from this direction
-			if (pieceColor != attackingColor)
-				break;
-
-			// If the first piece we encounter is a rook or queen of attacking color then the position is attacked
-			if (pieceType == Piece::Type::ROOK || pieceType == Piece::Type::QUEEN)
-				return true;
-
-			// If the piece is not a rook or a queen then the position can not be attacked from this direction
-			break;
+			pinnedPieces |= blockers;
+			pinRays[leastSignificantSquare(blockers)] = betweenSquares[king][sniper] | squareBitboard(sniper);
 		}
-
-		positionToCheck = positionToCheck.Left();
 	}
 
-	// Check in the right direction
-	positionToCheck = position.Right();
-	while (validPosition(positionToCheck))
+	for (int pieceType = Piece::Type::PAWN; pieceType < Piece::Type::KING; pieceType++)
 	{
-		Piece::Type pieceType = this->getPiece(positionToCheck).getType();
-		Piece::Color pieceColor = this->getPiece(positionToCheck).getColor();
-
-		// The first piece we encounter
-		if (pieceType != Piece::Type::NONE)
+		// Go through the pieces of the current type that belong to the player
+		Bitboard pieces = this->pieceBitboards[pieceType] & ownPieces;
+		while (pieces)
 		{
-			// If the piece is not of the attacking color then the position can not be attacked from this direction
-			if (pieceColor != attackingColor)
+			Square square = popLeastSignificantSquare(pieces);
+			int firstMove = moves.size();
+
+			switch (pieceType)
+			{
+			case Piece::Type::PAWN:
+				this->addPawnMoves(moves, square, playerColor, capturesOnly);
 				break;
 
-			// If the first piece we encounter is a rook or queen of attacking color then the position is attacked
-			if (pieceType == Piece::Type::ROOK || pieceType == Piece::Type::QUEEN)
-				return true;
+			case Piece::Type::BISHOP:
+				this->addBishopMoves(moves, square, playerColor, capturesOnly);
+				break;
 
-			// If the piece is not a rook or a queen then the position can not be attacked from this direction
-			break;
-		}
+			case Piece::Type::KNIGHT:
+				this->addKnightMoves(moves, square, playerColor, capturesOnly);
+				break;
 
-		positionToCheck = positionToCheck.Right();
-	}
+			case Piece::Type::ROOK:
+				this->addRookMoves(moves, square, playerColor, capturesOnly);
+				break;
 
-	// Check in the up-left direction
-	positionToCheck = position.UpLeft();
-	while (validPosition(positionToCheck))
-	{
-		Piece::Type pieceType = this->getPiece(positionToCheck).getType();
-		Piece::Color pieceColor = this->getPiece(positionToCheck).getColor();
+			case Piece::Type::QUEEN:
+				this->addQueenMoves(moves, square, playerColor, capturesOnly);
+				break;
 
-		// The first piece we encounter
-		if (pieceType != Piece::Type::NONE)
-		{
-			// If the piece is not of the attacking color then the position can not be attacked from this direction
-			if (pieceColor != attackingColor)
+			default:
 				break;
+			}
 
-			// If the first piece we encounter is a bishop or queen of attacking color then the position is attacked
-			if (pieceType == Piece::Type::BISHOP || pieceType == Piece::Type::QUEEN)
-				return true;
+			// Keep the moves that stay on the pin line and answer the check (en passant is checked on its own)
+			Bitboard allowedTargets = checkMask;
+			if (pinnedPieces & squareBitboard(square))
+				allowedTargets &= pinRays[square];
 
-			// If the piece is not a bishop or a queen then the position can not be attacked from this direction
-			break;
+			legalCount = firstMove;
+			for (int i = firstMove; i < moves.size(); i++)
+			{
+				bool legal = moves[i].getFlag() == Move::Flag::EN_PASSANT ? this->isLegalEnPassant(moves[i], king) : (allowedTargets & squareBitboard(moves[i].getTargetSquare())) != 0;
+				if (legal)
+					moves[legalCount++] = moves[i];
+			}
+			moves.truncate(legalCount);
 		}
-
-		positionToCheck = positionToCheck.UpLeft();
 	}
+}
 
-	// Check in the up-right direction
-	positionToCheck = position.UpRight();
-	while (validPosition(positionToCheck))
-	{
-		Piece::Type pieceType = this->getPiece(positionToCheck).getType();
-		Piece::Color pieceColor = this->getPiece(positionToCheck).getColor();
-
-		// The first piece we encounter
-		if (pieceType != Piece::Type::NONE)
-		{
-			// If the piece is not of the attacking color then the position can not be attacked from this direction
-			if (pieceColor != attackingColor)
-				break;
+Bitboard Board::attackersTo(const Square square, const Bitboard occupied) const
+{
+	Bitboard rooksAndQueens = this->pieceBitboards[Piece::Type::ROOK] | this->pieceBitboards[Piece::Type::QUEEN];
+	Bitboard bishopsAndQueens = this->pieceBitboards[Piece::Type::BISHOP] | this->pieceBitboards[Piece::Type::QUEEN];
+
+	return (pawnAttacks[1][square] & this->colorBitboards[0] & this->pieceBitboards[Piece::Type::PAWN]) |
+		(pawnAttacks[0][square] & this->colorBitboards[1] & this->pieceBitboards[Piece::Type::PAWN]) |
+		(knightAttacks[square] & this->pieceBitboards[Piece::Type::KNIGHT]) |
+		(kingAttacks[square] & this->pieceBitboards[Piece::Type::KING]) |
+		(rookAttacks(square, occupied) & rooksAndQueens) |
+		(bishopAttacks(square, occupied) & bishopsAndQueens);
+}
 
-			// If the first piece we encounter is a bishop or queen of attacking color then the position is attacked
-			if (pieceType == Piece::Type::BISHOP || pieceType == Piece::Type::QUEEN)
-				return true;
+bool Board::isLegalEnPassant(const Move move, const Square kingSquare) const
+{
+	Square initialSquare = move.getInitialSquare();
+	Square targetSquare = move.getTargetSquare();
+	// The captured pawn stands on the row the capturing pawn leaves and on the column it goes to
+	Square capturedSquare = squareIndex(squareRow(initialSquare), squareColumn(targetSquare));
 
-			// If the piece is not a bishop or a queen then the position can not be attacked from this direction
-			break;
-		}
+	Bitboard occupied = (this->occupiedSquares() ^ squareBitboard(initialSquare) ^ squareBitboard(capturedSquare)) | squareBitboard(targetSquare);
+	int enemyIndex = 1 - getColorIndex(this->getPiece(initialSquare).getColor());
+	Bitboard enemyPieces = this->colorBitboards[enemyIndex] & ~squareBitboard(capturedSquare);
 
-		positionToCheck = positionToCheck.UpRight();
-	}
+	return !(this->attackersTo(kingSquare, occupied) & enemyPieces);
+}
 
-	// Check in the down-left direction
-	positionToCheck = position.DownLeft();
-	while (validPosition(positionToCheck))
-	{
-		Piece::Type pieceType = this->getPiece(positionToCheck).getType();
-		Piece::Color pieceColor = this->getPiece(positionToCheck).getColor();
+bool Board::isQuietMove(const Move move) const
+{
+	if (move.getFlag() == Move::Flag::EN_PASSANT || move.getFlag() == Move::Flag::PROMOTION)
+		return false;
 
-		// The first piece we encounter
-		if (pieceType != Piece::Type::NONE)
-		{
-			// If the piece is not of the attacking color then the position can not be attacked from this direction
-			if (pieceColor != attackingColor)
-				break;
+	return !(this->occupiedSquares() & squareBitboard(move.getTargetSquare()));
+}
 
-			// If the first piece we encounter is a bishop or queen of attacking color then the position is attacked
-			if (pieceType == Piece::Type::BISHOP || pieceType == Piece::Type::QUEEN)
-				return true;
+bool Board::givesCheck(const Move move) const
+{
+	Square initialSquare = move.getInitialSquare();
+	Square targetSquare = move.getTargetSquare();
+	Piece piece = this->getPiece(initialSquare);
+	int colorIndex = getColorIndex(piece.getColor());
+	Square enemyKing = this->kingSquare(piece.getColor() == Piece::Color::WHITE ? Piece::Color::BLACK : Piece::Color::WHITE);
+	Piece::Type type = move.getFlag() == Move::Flag::PROMOTION ? move.getPromotionType() : piece.getType();
 
-			// If the piece is not a bishop or a queen then the position can not be attacked from this direction
-			break;
-		}
+	// The occupied squares once the move is made (a captured piece is replaced by the moving one)
+	Bitboard occupied = (this->occupiedSquares() ^ squareBitboard(initialSquare)) | squareBitboard(targetSquare);
 
-		positionToCheck = positionToCheck.DownLeft();
+	if (move.getFlag() == Move::Flag::EN_PASSANT)
+	{
+		occupied ^= squareBitboard(squareIndex(squareRow(initialSquare), squareColumn(targetSquare)));
 	}
-
-	// Check in the down-right direction
-	positionToCheck = position.DownRight();
-	while (validPosition(positionToCheck))
+	else if (move.getFlag() == Move::Flag::CASTLING)
 	{
-		Piece::Type pieceType = this->getPiece(positionToCheck).getType();
-		Piece::Color pieceColor = this->getPiece(positionToCheck).getColor();
-
-		// The first piece we encounter
-		if (pieceType != Piece::Type::NONE)
-		{
-			// If the piece is not of the attacking color then the position can not be attacked from this direction
-			if (pieceColor != attackingColor)
-				break;
-
-			// If the first piece we encounter is a bishop or queen of attacking color then the position is attacked
-			if (pieceType == Piece::Type::BISHOP || pieceType == Piece::Type::QUEEN)
-				return true;
-
-			// If the piece is not a bishop or a queen then the position can not be attacked from this direction
-			break;
-		}
-
-		positionToCheck = positionToCheck.DownRight();
+		// Only the rook can give check after castling
+		int row = squareRow(initialSquare);
+		bool kingside = squareColumn(targetSquare) == 6;
+		Square rookInitialSquare = squareIndex(row, kingside ? 7 : 0);
+		Square rookTargetSquare = squareIndex(row, kingside ? 5 : 3);
+		occupied ^= squareBitboard(rookInitialSquare) | squareBitboard(rookTargetSquare);
+
+		return (rookAttacks(rookTargetSquare, occupied) & squareBitboard(enemyKing)) != 0;
 	}
 
-	// Check for knights
-	int row = position.row();
-	int column = position.column();
-
-	// All possible positions from which a knight can attack the piece
-	Piece pieces[8] =
+	// Direct check by the moved piece
+	Bitboard attacks = 0;
+	switch (type)
 	{
-		validPosition(row - 1, column - 2) ? this->board[row - 1][column - 2] : Piece(),
-		validPosition(row - 2, column - 1) ? this->board[row - 2][column - 1] : Piece(),
-		validPosition(row - 2, column + 1) ? this->board[row - 2][column + 1] : Piece(),
-		validPosition(row - 1, column + 2) ? this->board[row - 1][column + 2] : Piece(),
-		validPosition(row + 1, column - 2) ? this->board[row + 1][column - 2] : Piece(),
-		validPosition(row + 2, column - 1) ? this->board[row + 2][column - 1] : Piece(),
-		validPosition(row + 2, column + 1) ? this->board[row + 2][column + 1] : Piece(),
-		validPosition(row + 1, column + 2) ? this->board[row + 1][column + 2] : Piece()
-	};
-
-	// Check if there is a knight of the attacking color on each of the possible positions
-	for (int i = 0; i < 8; i++)
-		if (pieces[i].getType() == Piece::KNIGHT && pieces[i].getColor() == attackingColor)
-			return true;
-
-	// Check for kings
-	row = position.row();
-	column = position.column();
+	case Piece::Type::PAWN:
+		attacks = pawnAttacks[colorIndex][targetSquare];
+		break;
+	case Piece::Type::KNIGHT:
+		attacks = knightAttacks[targetSquare];
+		break;
+	case Piece::Type::BISHOP:
+		attacks = bishopAttacks(targetSquare, occupied);
+		break;
+	case Piece::Type::ROOK:
+		attacks = rookAttacks(targetSquare, occupied);
+		break;
+	case Piece::Type::QUEEN:
+		attacks = queenAttacks(targetSquare, occupied);
+		break;
+	default:
+		break;
+	}
+	if (attacks & squareBitboard(enemyKing))
+		return true;
 
-	for (int i = row - 1; i <= row + 1; i++)
-		for (int j = column - 1; j <= column + 1; j++)
-			if ((i != row || j != column) && validPosition(i, j))
-				if (this->board[i][j].getType() == Piece::Type::KING && this->board[i][j].getColor() == attackingColor)
-					return true;
+	// Discovered check by a sliding piece the move uncovers (the moved piece is left out, its own attacks are already known)
+	Bitboard sliders = this->colorBitboards[colorIndex] ^ squareBitboard(initialSquare);
+	Bitboard rooksAndQueens = sliders & (this->pieceBitboards[Piece::Type::ROOK] | this->pieceBitboards[Piece::Type::QUEEN]);
+	Bitboard bishopsAndQueens = sliders & (this->pieceBitboards[Piece::Type::BISHOP] | this->pieceBitboards[Piece::Type::QUEEN]);
 
-	return false;
+	return ((rookAttacks(enemyKing, occupied) & rooksAndQueens) | (bishopAttacks(enemyKing, occupied) & bishopsAndQueens)) != 0;
 }
 
-bool Board::isInCheck(const Piece::Color color) const
+int Board::staticExchangeEvaluation(const Move move) const
 {
-	if (color == Piece::Color::WHITE)
-		return this->isAttackedBy(this->whiteKingPosition, Piece::Color::BLACK);
-	return this->isAttackedBy(this->blackKingPosition, Piece::Color::WHITE);
-}
+	// The attackers are tried from the least valuable one
+	static const Piece::Type exchangeOrder[6] = { Piece::Type::PAWN, Piece::Type::KNIGHT, Piece::Type::BISHOP, Piece::Type::ROOK, Piece::Type::QUEEN, Piece::Type::KING };
 
-Board::GameState Board::getGameState(const Piece::Color color, const std::vector<Move>& possibleMoves)
-{
-	// Check if the king is in check or not
-	bool check = this->isInCheck(color);
+	Square initialSquare = move.getInitialSquare();
+	Square targetSquare = move.getTargetSquare();
+	Piece movingPiece = this->mailbox[initialSquare];
+	Piece::Type attackerType = movingPiece.getType();
+	Bitboard occupied = this->occupiedSquares() ^ squareBitboard(initialSquare);
 
-	// Check each move and if the king is not in check after it then the game is not finished
-	for (Move move : possibleMoves)
-	{
-		// Make the move on the board
-		this->makeMove(move);
+	// gains[i] is the material won by the player making capture i if the exchange stopped after it
+	int gains[32];
+	int depth = 0;
 
-		// Check if the king is not in check
-		if (!this->isInCheck(color))
-		{
-			// If so, undo the move and return false
-			this->undoMove();
-			return GameState::UNFINISHED;
-		}
-		
-		// If this line is reached then the current move got the king in check and has to be undone
-		this->undoMove();
+	// The pawn captured en passant is not on the target square
+	if (move.getFlag() == Move::Flag::EN_PASSANT)
+	{
+		gains[0] = pieceValue[Piece::Type::PAWN];
+		occupied ^= squareBitboard(squareIndex(squareRow(initialSquare), squareColumn(targetSquare)));
+	}
+	else
+	{
+		gains[0] = pieceValue[this->mailbox[targetSquare].getType()];
 	}
 
-	// If this line was reached then all possible moves get the king in check
-	if (check)
-		return GameState::CHECKMATE; // If the king is already in check himself then it is checkmate
-	return GameState::STALEMATE; // Otherwise it is stalemate as there are no legal moves but there is no check
-}
+	// A promoting pawn gains the value of the new piece and is captured as that piece
+	if (move.getFlag() == Move::Flag::PROMOTION)
+	{
+		gains[0] += pieceValue[move.getPromotionType()] - pieceValue[Piece::Type::PAWN];
+		attackerType = move.getPromotionType();
+	}
 
-std::vector<Move> Board::getMoves(const Piece::Color playerColor) const
-{
-	int index = getColorIndex(playerColor);
-	std::vector<Move> moves;
+	Bitboard rooksAndQueens = this->pieceBitboards[Piece::Type::ROOK] | this->pieceBitboards[Piece::Type::QUEEN];
+	Bitboard bishopsAndQueens = this->pieceBitboards[Piece::Type::BISHOP] | this->pieceBitboards[Piece::Type::QUEEN];
+	Bitboard attackers = this->attackersTo(targetSquare, occupied) & occupied;
+	int colorIndex = 1 - getColorIndex(movingPiece.getColor());
 
-	for (Position position : this->occupiedSquares[index])
+	while (depth < 31)
 	{
-		Piece piece = this->getPiece(position);
-		switch (piece.getType())
-		{
-		case Piece::Type::PAWN:
-			this->addPawnMoves(moves, piece);
-			break;
-			
-		case Piece::Type::BISHOP:
-			this->addBishopMoves(moves, piece);
+		Bitboard ownAttackers = attackers & this->colorBitboards[colorIndex];
+		if (ownAttackers == 0)
 			break;
 
-		case Piece::Type::KNIGHT:
-			this->addKnightMoves(moves, piece);
-			break;
+		Piece::Type capturingType = Piece::Type::NONE;
+		Bitboard candidates = 0;
+		for (const Piece::Type type : exchangeOrder)
+		{
+			candidates = ownAttackers & this->pieceBitboards[type];
+			if (candidates != 0)
+			{
+				capturingType = type;
+				break;
+			}
+		}
 
-		case Piece::Type::ROOK:
-			this->addRookMoves(moves, piece);
-			break;
+		// The piece on the square is captured (whether the capture pays off is decided once the whole exchange is known)
+		depth++;
+		gains[depth] = pieceValue[attackerType] - gains[depth - 1];
 
-		case Piece::Type::QUEEN:
-			this->addQueenMoves(moves, piece);
-			break;
-			
-		case Piece::Type::KING:
-			this->addKingMoves(moves, piece);
-			break;
+		// The sliders behind the piece that captured can now reach the square (x-rays)
+		occupied ^= squareBitboard(leastSignificantSquare(candidates));
+		attackers |= (bishopAttacks(targetSquare, occupied) & bishopsAndQueens) | (rookAttacks(targetSquare, occupied) & rooksAndQueens);
+		attackers &= occupied;
 
-		default:
-			break;
-		}
+		attackerType = capturingType;
+		colorIndex = 1 - colorIndex;
 	}
 
-	std::sort(moves.begin(), moves.end(), [&](const Move& a, const Move& b) { return this->compareMoves(a, b); });
+	// Going back from the last capture, each player only captures if it gains more than stopping
+	while (depth > 0)
+	{
+		gains[depth - 1] = -std::max(-gains[depth - 1], gains[depth]);
+		depth--;
+	}
 
-	return moves;
+	return gains[0];
 }
 
 void Board::castle(const Move move)
 {
-	Position kingInitialPosition = move.getInitialPosition();
-	Position kingTargetPosition = move.getTargetPosition();
-	Piece king = this->getPiece(kingInitialPosition);
-	
-	Position rookTargetPosition;
-	Piece rook;
-
-	// Get rook information
-	if (king.getColor() == Piece::Color::WHITE) // White king castles
-	{
-		if (kingTargetPosition == Position(7, 6)) // Kingside
-		{
-			rookTargetPosition = Position(7, 5);
-			rook = this->getPiece(Position(7, 7));
-		}
-		else // Queenside
-		{
-			rookTargetPosition = Position(7, 3);
-			rook = this->getPiece(Position(7, 0));
-		}
-	}
-	else // Black king castles
-	{
-		if (kingTargetPosition == Position(0, 6)) // Kingside
-		{
-			rookTargetPosition = Position(0, 5);
-			rook = this->getPiece(Position(0, 7));
-		}
-		else // Queenside
-		{
-			rookTargetPosition = Position(0, 3);
-			rook = this->getPiece(Position(0, 0));
-		}
-	}
-
-	// Remove the king from his position
-	this->removePiece(king);
-	this->applyChangeToZobristHash(king);
-
-	// Create a new king piece at the target position with hasMoved = true
-	Piece movedKing = Piece(king.getType(), king.getColor(), kingTargetPosition, true);
-	this->addPiece(movedKing);
-	this->applyChangeToZobristHash(movedKing);
-
-	// Remove the rook from his position
-	this->removePiece(rook);
-	this->applyChangeToZobristHash(rook);
-
-	// Create a new rook piece at the target position with hasMoved = true
-	Piece movedRook = Piece(rook.getType(), rook.getColor(), rookTargetPosition, true);
-	this->addPiece(movedRook);
-	this->applyChangeToZobristHash(movedRook);
-
-	// Add a separator at the end of the move
-	this->actionsMade.push(Action::SEPARATOR);
+	Square kingInitialSquare = move.getInitialSquare();
+	Square kingTargetSquare = move.getTargetSquare();
+	Piece king = this->getPiece(kingInitialSquare);
+
+	// The rook jumps from its corner to the square the king passed over
+	int row = squareRow(kingInitialSquare);
+	bool kingside = squareColumn(kingTargetSquare) == 6;
+	Square rookInitialSquare = squareIndex(row, kingside ? 7 : 0);
+	Square rookTargetSquare = squareIndex(row, kingside ? 5 : 3);
+	Piece rook = this->getPiece(rookInitialSquare);
+
+	// Move the king to its target square
+	this->removePiece(kingInitialSquare);
+	this->applyChangeToZobristHash(king, kingInitialSquare);
+	this->addPiece(king, kingTargetSquare);
+	this->applyChangeToZobristHash(king, kingTargetSquare);
+
+	// Move the rook to its target square
+	this->removePiece(rookInitialSquare);
+	this->applyChangeToZobristHash(rook, rookInitialSquare);
+	this->addPiece(rook, rookTargetSquare);
+	this->applyChangeToZobristHash(rook, rookTargetSquare);
 }
 
 void Board::enPassant(const Move move)
 {
-	Position initialPosition = move.getInitialPosition();
-	Position targetPosition = move.getTargetPosition();
-	Piece pawn = this->getPiece(initialPosition);
-
-	// Remove the captured pawn below targetPosition
-	Position positionToCapture = (pawn.getColor() == Piece::Color::WHITE) ? targetPosition.Down() : targetPosition.Up();
-	Piece pawnToBeCaptured = this->getPiece(positionToCapture);
-	this->removePiece(pawnToBeCaptured);
-	this->applyChangeToZobristHash(pawnToBeCaptured);
-
-	// Remove the pawn from its initial position
-	this->removePiece(pawn);
-	this->applyChangeToZobristHash(pawn);
-
-	// Create a new pawn piece at the target position with hasMoved = true
-	Piece movedPawn = Piece(pawn.getType(), pawn.getColor(), targetPosition, true);
-	this->addPiece(movedPawn);
-	this->applyChangeToZobristHash(movedPawn);
+	Square initialSquare = move.getInitialSquare();
+	Square targetSquare = move.getTargetSquare();
+	Piece pawn = this->getPiece(initialSquare);
+
+	// Remove the captured pawn behind the target square
+	Square squareToCapture = shiftSquare(targetSquare, pawn.getColor() == Piece::Color::WHITE ? Direction::DOWN : Direction::UP);
+	Piece pawnToBeCaptured = this->getPiece(squareToCapture);
+	this->removePiece(squareToCapture);
+	this->applyChangeToZobristHash(pawnToBeCaptured, squareToCapture);
+	this->undoHistory[this->historySize - 1].capturedPiece = pawnToBeCaptured;
+
+	// Move the pawn to the target square
+	this->removePiece(initialSquare);
+	this->applyChangeToZobristHash(pawn, initialSquare);
+	this->addPiece(pawn, targetSquare);
+	this->applyChangeToZobristHash(pawn, targetSquare);
+}
 
-	this->actionsMade.push(Action::SEPARATOR);
+void Board::passTheTurn()
+{
+	this->sideToMove = this->sideToMove == Piece::Color::WHITE ? Piece::Color::BLACK : Piece::Color::WHITE;
+	this->zobristHash = this->zobristHash ^ zobristKeys.blackToMove;
 }
 
-bool Board::compareMoves(const Move& firstMove, const Move& secondMove) const
+void Board::applyChangeToZobristHash(const Piece piece, const Square square)
 {
-	// Check if the first move is the one stored in the transposition table for the current state of the board
-	if (firstMove == this->transpositionTable[this->getZobristHash()].move)
-		return true;
+	uint64_t key = zobristKeys.pieces[getColorIndex(piece.getColor())][piece.getType()][square];
+	this->zobristHash = this->zobristHash ^ key;
+	if (piece.getType() == Piece::Type::PAWN)
+		this->pawnHash ^= key;
+}
 
-	// Check if the second move is the one stored in the transposition table for the current state of the board
-	if (secondMove == this->transpositionTable[this->getZobristHash()].move)
+bool Board::makeMove(const Move move)
+{
+	// Every move needs a record to be undone
+	if (this->historySize >= maxHistorySize)
 		return false;
 
-	// Check if the first move is the best one from the previous depth
-	if (firstMove == this->bestMoveForPreviousDepth)
-		return true;
+	Square initialSquare = move.getInitialSquare();
+	Square targetSquare = move.getTargetSquare();
+	Piece pieceToMove = this->getPiece(initialSquare);
+
+	// Store everything needed to undo the move
+	UndoRecord& record = this->undoHistory[this->historySize++];
+	record.move = move;
+	record.movedPieceType = pieceToMove.getType();
+	record.capturedPiece = Piece();
+	record.castlingRights = this->castling;
+	record.enPassantSquare = this->enPassantSquare;
+	record.halfmoveClock = this->halfmoveClock;
+	record.zobristHash = this->zobristHash;
+	record.pawnHash = this->pawnHash;
+	record.middlegameEvaluation = this->middlegameEvaluation;
+	record.endgameEvaluation = this->endgameEvaluation;
+	record.gamePhase = this->gamePhase;
+
+	// The hidden layer of the network after the move starts as a copy of the one before it
+	if (this->network)
+		this->accumulators[this->historySize] = this->accumulators[this->historySize - 1];
+
+	int previousEnPassantSquare = this->enPassantSquare;
+	int previousCastlingRights = this->castling;
+	this->enPassantSquare = -1;
+
+	// The clock of the fifty move rule starts again after a pawn move or a capture (checked below) and the full move number grows after black moves
+	this->halfmoveClock = pieceToMove.getType() == Piece::Type::PAWN ? 0 : this->halfmoveClock + 1;
+	if (this->sideToMove == Piece::Color::BLACK)
+		this->fullmoveNumber++;
+
+	// Castles and en passant captures are marked by the move generator
+	if (move.getFlag() == Move::Flag::CASTLING)
+	{
+		this->castle(move);
+	}
+	else if (move.getFlag() == Move::Flag::EN_PASSANT)
+	{
+		this->enPassant(move);
+	}
+	else
+	{
+		Piece pieceToGetCaptured = this->getPiece(targetSquare);
 
-	// Check if the second move is the best one from the previous depth
-	if (secondMove == this->bestMoveForPreviousDepth)
-		return false;
+		// If the target square is occupied by another piece, then remove it
+		if (pieceToGetCaptured.getType() != Piece::Type::NONE)
+		{
+			record.capturedPiece = pieceToGetCaptured;
+			this->halfmoveClock = 0;
+			this->removePiece(targetSquare);
+			this->applyChangeToZobristHash(pieceToGetCaptured, targetSquare);
+		}
 
-	Position firstTargetPosition = firstMove.getTargetPosition();
-	Position secondTargetPosition = secondMove.getTargetPosition();
+		// Remove the piece to move from its square
+		this->removePiece(initialSquare);
+		this->applyChangeToZobristHash(pieceToMove, initialSquare);
 
-	Piece::Type firstCapturedPieceType = this->getPiece(firstTargetPosition).getType();
-	Piece::Type secondCapturedPieceType = this->getPiece(secondTargetPosition).getType();
+		// Add the piece to move to the target square
+		Piece movedPiece = pieceToMove;
+		if (move.getPromotionType() != Piece::Type::NONE && pieceToMove.getType() == Piece::Type::PAWN) // Check if the move is a pawn promotion
+			movedPiece.setType(move.getPromotionType());
+		this->addPiece(movedPiece, targetSquare);
+		this->applyChangeToZobristHash(movedPiece, targetSquare);
 
-	if (pieceValue[firstCapturedPieceType] > pieceValue[secondCapturedPieceType]) // Check if the first move captures a more valuable piece than the second move does
-		return true;
+		// A pawn that moves two squares forward can be captured en passant on the square it passed over
+		if (pieceToMove.getType() == Piece::Type::PAWN && abs(targetSquare - initialSquare) == 16)
+			this->enPassantSquare = (initialSquare + targetSquare) / 2;
+	}
 
-	Position firstInitialPosition = firstMove.getInitialPosition();
-	Position secondInitialPosition = secondMove.getInitialPosition();
+	// Update the hash with the castling rights lost by moving a king or a rook (or capturing a rook) and the new en passant square
+	this->castling &= castlingRightsKept[initialSquare] & castlingRightsKept[targetSquare];
+	if (this->castling != previousCastlingRights)
+		this->zobristHash ^= castlingZobristValue(previousCastlingRights) ^ castlingZobristValue(this->castling);
+	if (previousEnPassantSquare != -1)
+		this->zobristHash ^= zobristKeys.enPassant[previousEnPassantSquare & 7];
+	if (this->enPassantSquare != -1)
+		this->zobristHash ^= zobristKeys.enPassant[this->enPassantSquare & 7];
 
-	Piece::Type firstPieceType = this->getPiece(firstInitialPosition).getType();
-	Piece::Type secondPieceType = this->getPiece(secondInitialPosition).getType();
+	// Give the turn to the other player
+	this->passTheTurn();
 
-	if (pieceValue[firstCapturedPieceType] == pieceValue[secondCapturedPieceType]) // In case of equal captures
-		if (pieceValue[firstPieceType] < pieceValue[secondPieceType]) // Check if the capturing piece of the first move is less valuable than the one of the second move
-			return true;
+	return true;
+}
 
-	if (pieceValue[firstCapturedPieceType] == pieceValue[secondCapturedPieceType]) // In case of equal captures
-		if (pieceValue[firstPieceType] == pieceValue[secondPieceType]) // And equal pieces
-		{
-			// Check if the first move gains a higher positional advantage then the second one
-			int firstDifference = 0;
-			int secondDifference = 0;
-			Piece::Color color = this->getPiece(firstInitialPosition).getColor();
+void Board::undoMove()
+{
+	if (this->historySize == 0)
+		return;
 
-			if (color == Piece::Color::WHITE)
-			{
-				firstDifference = positionValue[firstPieceType][firstTargetPosition.row()][firstTargetPosition.column()] - positionValue[firstPieceType][firstInitialPosition.row()][firstInitialPosition.column()];
-				secondDifference = positionValue[secondPieceType][secondTargetPosition.row()][secondTargetPosition.column()] - positionValue[secondPieceType][secondInitialPosition.row()][secondInitialPosition.column()];
-			}
-			else
-			{
-				firstDifference = positionValue[firstPieceType][7 - firstTargetPosition.row()][firstTargetPosition.column()] - positionValue[firstPieceType][7 - firstInitialPosition.row()][firstInitialPosition.column()];
-				secondDifference = positionValue[secondPieceType][7 -secondTargetPosition.row()][secondTargetPosition.column()] - positionValue[secondPieceType][7 - secondInitialPosition.row()][secondInitialPosition.column()];
-			}
+	const UndoRecord& record = this->undoHistory[--this->historySize];
+	Square initialSquare = record.move.getInitialSquare();
+	Square targetSquare = record.move.getTargetSquare();
+	Piece movedPiece = this->getPiece(targetSquare);
 
-			if (firstDifference > secondDifference)
-				return true;
-		}
+	// Move the piece back to its initial square (a promoted piece turns back into a pawn)
+	this->togglePiece(movedPiece.getType(), movedPiece.getColor(), targetSquare);
+	this->togglePiece(record.movedPieceType, movedPiece.getColor(), initialSquare);
+
+	// Move the rook back to its corner if the move was a castle
+	if (record.move.getFlag() == Move::Flag::CASTLING)
+	{
+		int row = squareRow(initialSquare);
+		bool kingside = squareColumn(targetSquare) == 6;
+		this->togglePiece(Piece::Type::ROOK, movedPiece.getColor(), squareIndex(row, kingside ? 5 : 3));
+		this->togglePiece(Piece::Type::ROOK, movedPiece.getColor(), squareIndex(row, kingside ? 7 : 0));
+	}
+
+	// Put back the captured piece (a pawn captured en passant stands on the row the capturing pawn left)
+	if (record.capturedPiece.getType() != Piece::Type::NONE)
+	{
+		Square capturedSquare = record.move.getFlag() == Move::Flag::EN_PASSANT ? squareIndex(squareRow(initialSquare), squareColumn(targetSquare)) : targetSquare;
+		this->togglePiece(record.capturedPiece.getType(), record.capturedPiece.getColor(), capturedSquare);
+	}
 
-	return false;
+	// Restore the state of the board from before the move
+	this->castling = record.castlingRights;
+	this->enPassantSquare = record.enPassantSquare;
+	this->halfmoveClock = record.halfmoveClock;
+	this->zobristHash = record.zobristHash;
+	this->pawnHash = record.pawnHash;
+	this->middlegameEvaluation = record.middlegameEvaluation;
+	this->endgameEvaluation = record.endgameEvaluation;
+	this->gamePhase = record.gamePhase;
+
+	// Give the turn back to the player that made the move
+	this->sideToMove = this->sideToMove == Piece::Color::WHITE ? Piece::Color::BLACK : Piece::Color::WHITE;
+	if (this->sideToMove == Piece::Color::BLACK)
+		this->fullmoveNumber--;
 }
 
-bool Board::isValid(const Move move, const Piece::Color playerToMove)
+// Compute the value of the current state of the board (positive values are better for white and negative values are better for black)
+int Board::evaluate() const
 {
-	Position initialPosition = move.getInitialPosition();
-	Position targetPosition = move.getTargetPosition();
+	// The network evaluates from the point of view of the player to move, its values are kept below the tablebase and mate scores
+	if (this->network)
+	{
+		int limit = tablebaseWinValue - 1;
+		int value = this->network->evaluate(this->accumulators[this->historySize], this->sideToMove);
+		value = std::min(std::max(value, -limit), limit);
+		return this->sideToMove == Piece::Color::WHITE ? value : -value;
+	}
 
-	// Check if the move is empty
-	if (initialPosition == targetPosition)
-		return false;
+	// The pawn structure is only computed the first time it is seen
+	PawnHashTable::Entry& pawns = this->pawnTable.getEntry(this->pawnHash);
+	if (pawns.key != this->pawnHash)
+	{
+		pawns.key = this->pawnHash;
+		this->evaluatePawnStructure(pawns.middlegameValue, pawns.endgameValue);
+	}
 
-	Piece pieceToMove = this->getPiece(initialPosition);
+	int middlegame = this->middlegameEvaluation + pawns.middlegameValue;
+	int endgame = this->endgameEvaluation + pawns.endgameValue;
 
-	// Check if the color of the moving piece is correct
-	if (pieceToMove.getColor() != playerToMove)
-		return false;
+	// Promotions can raise the phase above the one of the starting position
+	int phase = this->gamePhase < maxGamePhase ? this->gamePhase : maxGamePhase;
 
-	Piece pieceToBeCaptured = this->getPiece(targetPosition);
+	return (middlegame * phase + endgame * (maxGamePhase - phase)) / maxGamePhase;
+}
 
-	// Check if the color of the captured piece is correct
-	if (pieceToBeCaptured.getColor() == playerToMove)
-		return false;
+void Board::evaluatePawnStructure(int& middlegameValue, int& endgameValue) const
+{
+	middlegameValue = 0;
+	endgameValue = 0;
 
-	// Check if the captured piece is a king
-	if (pieceToBeCaptured.getType() == Piece::Type::KING)
-		return false;
-	
-	if (pieceToMove.getType() == Piece::Type::NONE)
+	for (int colorIndex = 0; colorIndex < 2; colorIndex++)
 	{
-		return false;
-	}
+		Bitboard ownPawns = this->pieceBitboards[Piece::Type::PAWN] & this->colorBitboards[colorIndex];
+		Bitboard enemyPawns = this->pieceBitboards[Piece::Type::PAWN] & this->colorBitboards[1 - colorIndex];
+		int middlegame = 0, endgame = 0;
 
-	if (pieceToMove.getType() == Piece::Type::PAWN)
-	{
-		if (pieceToMove.getColor() == Piece::Color::WHITE)
+		Bitboard pawns = ownPawns;
+		while (pawns)
 		{
-			if (targetPosition == initialPosition.Up())
+			Square square = popLeastSignificantSquare(pawns);
+			int column = squareColumn(square);
+
+			// Only the pawn behind another pawn of its color counts as doubled, so two pawns on a column are one penalty
+			bool doubled = (ownPawns & forwardSquares[colorIndex][square]) != 0;
+			bool isolated = (ownPawns & adjacentColumns[column]) == 0;
+
+			// A pawn is backward if all the pawns on the columns next to it are in front of it and an enemy pawn guards the square in front of it
+			Square stopSquare = shiftSquare(square, colorIndex == 0 ? Direction::UP : Direction::DOWN);
+			bool backward = !isolated && (ownPawns & adjacentColumns[column] & ~pawnAttackSpan[colorIndex][square]) == 0 && (enemyPawns & pawnAttacks[colorIndex][stopSquare]) != 0;
+
+			// A passed pawn has no enemy pawn in front of it or on the columns next to it (the bonus goes to the front pawn of a doubled pair)
+			bool passed = !doubled && (enemyPawns & (forwardSquares[colorIndex][square] | pawnAttackSpan[colorIndex][square])) == 0;
+
+			if (doubled)
 			{
-				// Square has to be empty
-				if (pieceToBeCaptured.getType() != Piece::Type::NONE)
-					return false;
+				middlegame -= doubledPawnPenalty[0];
+				endgame -= doubledPawnPenalty[1];
 			}
-			else if (targetPosition == initialPosition.Up().Up())
+			if (isolated)
 			{
-				// The pawn must be on its first move
-				if (pieceToMove.hasMoved())
-					return false;
-				
-				// The square must be empty
-				if (pieceToBeCaptured.getType() != Piece::Type::NONE)
-					return false;
+				middlegame -= isolatedPawnPenalty[0];
+				endgame -= isolatedPawnPenalty[1];
 			}
-			else if (targetPosition == initialPosition.UpLeft() || targetPosition == initialPosition.UpRight())
+			if (backward)
 			{
-				// Check for en passant
-				if (pieceToBeCaptured.getType() == Piece::Type::NONE)
-				{
-					// En passant with a white pawn only takes place when it is on row 3
-					if (pieceToMove.getPosition().row() != 3)
-						return false;
-
-					Piece lastRemovedPiece = this->removedPieces.top();
-					Piece lastAddedPiece = this->addedPieces.top();
-
-					// Check if the last moved piece is a pawn
-					if (!(lastRemovedPiece.getType() == Piece::Type::PAWN && lastAddedPiece.getType() == Piece::Type::PAWN))
-						return false;
-					
-					// Check if the pawn moved 2 pieces forward
-					if (!(!lastRemovedPiece.hasMoved() && lastAddedPiece.getPosition() == targetPosition.Down()))
-						return false;
-				}
+				middlegame -= backwardPawnPenalty[0];
+				endgame -= backwardPawnPenalty[1];
 			}
-			else
+			if (passed)
 			{
-				return false;
+				int rank = colorIndex == 0 ? 7 - squareRow(square) : squareRow(square);
+				middlegame += passedPawnBonus[0][rank];
+				endgame += passedPawnBonus[1][rank];
 			}
 		}
-		else
-		{
-			if (targetPosition == initialPosition.Down())
-			{
-				// Square has to be empty
-				if (pieceToBeCaptured.getType() != Piece::Type::NONE)
-					return false;
-			}
-			else if (targetPosition == initialPosition.Down().Down())
-			{
-				// The pawn must be on its first move
-				if (pieceToMove.hasMoved())
-					return false;
 
-				// The square must be empty
-				if (pieceToBeCaptured.getType() != Piece::Type::NONE)
-					return false;
-			}
-			else if (targetPosition == initialPosition.DownLeft() || targetPosition == initialPosition.DownRight())
-			{
-				// Check for en passant
-				if (pieceToBeCaptured.getType() == Piece::Type::NONE)
-				{
-					// En passant with a black pawn only takes place when it is on row 4
-					if (pieceToMove.getPosition().row() != 4)
-						return false;
-
-					Piece lastRemovedPiece = this->removedPieces.top();
-					Piece lastAddedPiece = this->addedPieces.top();
-
-					// Check if the last moved piece is a pawn
-					if (!(lastRemovedPiece.getType() == Piece::Type::PAWN && lastAddedPiece.getType() == Piece::Type::PAWN))
-						return false;
-
-					// Check if the pawn moved 2 pieces forward
-					if (!(!lastRemovedPiece.hasMoved() && lastAddedPiece.getPosition() == targetPosition.Up()))
-						return false;
-				}
-			}
-			else
-			{
-				return false;
-			}
-		}
+		middlegameValue += colorIndex == 0 ? middlegame : -middlegame;
+		endgameValue += colorIndex == 0 ? endgame : -endgame;
 	}
+}
 
-	if (pieceToMove.getType() == Piece::Type::BISHOP)
-	{
-		int rowDifference = targetPosition.row() - initialPosition.row();
-		int columnDifference = targetPosition.column() - initialPosition.column();
-
-		// Make sure the initial position and target position are on the same diagonal
-		if (abs(rowDifference) != abs(columnDifference))
-			return false;
-
-		// Make sure the positions are not the same
-		if (rowDifference == 0)
-			return false;
-
-		int absDifference = abs(rowDifference);
-		Position direction(rowDifference / absDifference, columnDifference / absDifference);
-
-		// Check if there is any piece between the initial position and the target position
-		Position positionToCheck = initialPosition + direction;
-		while (positionToCheck != targetPosition)
-		{
-			if (this->getPiece(positionToCheck).getType() != Piece::Type::NONE)
-				return false;
-
-			positionToCheck = positionToCheck + direction;
-		}
-	}
+Move Board::getBestMove(const SearchLimits& limits)
+{
+	Move result = Move();
+	this->timeManager.start(limits, this->sideToMove);
+	this->searchController->start(limits, this->timeManager.isTimed() ? this->timeManager.hardLimit() : -1);
 
-	if (pieceToMove.getType() == Piece::Type::ROOK)
+	// With few enough pieces the tablebases know the best move, the one that keeps the result and gets closest to the next capture or pawn move
+	Tablebases::Wdl rootWdl;
+	if (this->canProbeTablebases() && this->tablebases->probeRoot(*this, result, rootWdl))
 	{
-		int rowDifference = targetPosition.row() - initialPosition.row();
-		int columnDifference = targetPosition.column() - initialPosition.column();
-
-		// Make sure the position are on the same line or column
-		if (rowDifference != 0 && columnDifference != 0)
-			return false;
-
-		// Make sure the positions are not the same
-		if (rowDifference == 0 && columnDifference == 0)
-			return false;
+		int score = rootWdl == Tablebases::Wdl::WIN ? tablebaseWinValue : rootWdl == Tablebases::Wdl::LOSS ? -tablebaseWinValue : (int)rootWdl;
+		std::cout << "info depth 1 score cp " << score << " nodes 0 tbhits 1 pv " << result.toAlgebraicString() << "\n" << std::flush;
 
-		int absDifference = std::max(abs(rowDifference), abs(columnDifference));
-		Position direction(rowDifference / absDifference, columnDifference / absDifference);
-
-		// Check if there is any piece between the initial position and the target position
-		Position positionToCheck = initialPosition + direction;
-		while (positionToCheck != targetPosition)
-		{
-			if (this->getPiece(positionToCheck).getType() != Piece::Type::NONE)
-				return false;
-
-			positionToCheck = positionToCheck + direction;
-		}
+		// The move is known at once but an infinite search only sends it once it is stopped
+		if (limits.infinite)
+			this->searchController->waitForStop();
+		return result;
 	}
 
-	if (pieceToMove.getType() == Piece::Type::QUEEN)
-	{
-		int rowDifference = targetPosition.row() - initialPosition.row();
-		int columnDifference = targetPosition.column() - initialPosition.column();
-
-		Position direction;
+	this->searchStopped = false;
+	this->pendingNodes = 0;
+	this->transpositionTable->newSearch();
 
-		if (abs(rowDifference) == abs(columnDifference))
-		{
-			int absDifference = abs(rowDifference);
-			direction = Position(rowDifference / absDifference, columnDifference / absDifference);
-		}
-		else if (rowDifference == 0 || columnDifference == 0)
-		{
-			int absDifference = std::max(abs(rowDifference), abs(columnDifference));
-			direction = Position(rowDifference / absDifference, columnDifference / absDifference);
-		}
-		else
-		{
-			return false;
-		}
-
-		// Check if there is any piece between the initial position and the target position
-		Position positionToCheck = initialPosition + direction;
-		while (positionToCheck != targetPosition)
-		{
-			if (this->getPiece(positionToCheck).getType() != Piece::Type::NONE)
-				return false;
-
-			positionToCheck = positionToCheck + direction;
-		}
+	// Start the helper threads, each one searches its own copy of the board (helpers with odd indices start one depth further to spread the work)
+	std::vector<std::unique_ptr<Board>> helperBoards;
+	std::vector<std::thread> helperThreads;
+	for (int i = 1; i < this->threadCount; i++)
+	{
+		helperBoards.push_back(std::unique_ptr<Board>(new Board(*this)));
+		helperThreads.push_back(std::thread(&Board::iterativeDeepening, helperBoards.back().get(), 1 + i % 2, false));
 	}
 
-	if (pieceToMove.getType() == Piece::Type::KNIGHT)
-	{
-		int rowDifference = targetPosition.row() - initialPosition.row();
-		int columnDifference = targetPosition.column() - initialPosition.column();
+	// Start a new thread that runs the search
+	std::thread searchThread([this, &result]() { result = this->iterativeDeepening(1, true); });
+	
+	// Wait until the search is stopped by the main search thread, the node limit or the stop command, or until the hard time limit is reached
+	this->searchController->waitForStop();
 
-		// Check if the move is an "L move"
-		if (!((abs(rowDifference) == 2 && abs(columnDifference) == 1) || (abs(rowDifference) == 1 && abs(columnDifference) == 2)))
-			return false;
+	// Notify the other threads to stop the search
+	this->searchController->stop();
 
-		// Check if the target square is available
-		if (!this->availableSquare(playerToMove, targetPosition.row(), targetPosition.column()))
-			return false;
-	}
+	searchThread.join();
+	for (std::thread& helperThread : helperThreads)
+		helperThread.join();
 
-	if (pieceToMove.getType() == Piece::Type::KING)
+	// If the search was stopped before the first depth was completed then play any legal move
+	if (result == Move())
 	{
-		int rowDifference = targetPosition.row() - initialPosition.row();
-		int columnDifference = targetPosition.column() - initialPosition.column();
-
-		// The king cannot move more than one row per move
-		if (abs(rowDifference) > 1)
-			return false;
+		MoveList moves;
+		this->getMoves(this->sideToMove, moves);
+		if (!moves.empty())
+			result = moves[0];
+	}
 
-		// A king can only move 1 column per move except when it casltes (2 columns)
-		if (abs(columnDifference) > 2)
-			return false;
+	return result;
+}
 
-		// Castle case
-		if (abs(columnDifference) == 2)
-		{
-			// The king cannot castle if it has already moved
-			if (pieceToMove.hasMoved())
-				return false;
+void Board::prepareSearch()
+{
+	this->searchController->reset();
+}
 
-			if (columnDifference == 2)
-			{
-				Piece possibleRook = this->getPiece(Position(initialPosition.row(), 7));
-
-				if (possibleRook.getType() == Piece::Type::ROOK && !possibleRook.hasMoved())
-				{
-					bool canCastle = true;
-
-					// Check if the square between the king and the rook are empty
-					for (int columnToCheck = initialPosition.column() + 1; columnToCheck < 7 && canCastle; columnToCheck++)
-						if (this->board[initialPosition.row()][columnToCheck].getType() != Piece::Type::NONE)
-							canCastle = false;
-
-					// Check if the squares the king would travel are attacked by the other color
-					Piece::Color otherColor = playerToMove == Piece::Color::WHITE ? Piece::Color::BLACK : Piece::Color::WHITE;
-					for (int columnToCheck = initialPosition.column(); columnToCheck <= initialPosition.column() + 2 && canCastle; columnToCheck++)
-						if (this->isAttackedBy(Position(initialPosition.row(), columnToCheck), otherColor))
-							canCastle = false;
-
-					if (!canCastle)
-						return false;
-				}
-				else
-				{
-					return false;
-				}
-			}
-			else
-			{
-				Piece possibleRook = this->getPiece(Position(initialPosition.row(), 0));
-
-				if (possibleRook.getType() == Piece::Type::ROOK && !possibleRook.hasMoved())
-				{
-					bool canCastle = true;
-
-					// Check if the square between the king and the rook are empty
-					for (int columnToCheck = 1; columnToCheck < initialPosition.column() && canCastle; columnToCheck++)
-						if (this->board[initialPosition.row()][columnToCheck].getType() != Piece::Type::NONE)
-							canCastle = false;
-
-					// Check if the squares the king would travel are attacked by the other color
-					Piece::Color otherColor = playerToMove == Piece::Color::WHITE ? Piece::Color::BLACK : Piece::Color::WHITE;
-					for (int columnToCheck = initialPosition.column() - 2; columnToCheck <= initialPosition.column() && canCastle; columnToCheck++)
-						if (this->isAttackedBy(Position(initialPosition.row(), columnToCheck), otherColor))
-							canCastle = false;
-
-					if (!canCastle)
-						return false;
-				}
-				else
-				{
-					return false;
-				}
-			}
-		}
-	}
+void Board::stopSearching()
+{
+	this->searchController->stop();
+}
 
-	// Check if the current move would put the king in check
-	this->makeMove(move);
-	bool kingInCheck = this->isInCheck(playerToMove);
-	this->undoMove();
+void Board::countNode()
+{
+	if (++this->pendingNodes < nodeCountInterval)
+		return;
 
-	return !kingInCheck;
+	this->searchController->addNodes(this->pendingNodes);
+	this->pendingNodes = 0;
+	this->searchStopped = this->searchController->isStopped();
 }
 
-void Board::passTheTurn()
+bool Board::setTranspositionTableSize(const int megabytes)
 {
-	this->zobristHash = this->zobristHash ^ this->blackToMoveZobristValue;
+	return this->transpositionTable->resize(std::max(1, megabytes));
 }
 
-int Board::getZobristHash() const
+Board::SearchOptions Board::getSearchOptions() const
 {
-	return this->zobristHash % this->transpositionTableSize;
+	return this->searchOptions;
 }
 
-void Board::applyChangeToZobristHash(const Piece piece)
+void Board::setSearchOptions(const SearchOptions& options)
 {
-	this->zobristHash = this->zobristHash ^ this->zobristValues[getColorIndex(piece.getColor())][piece.getType()][piece.getPosition().row()][piece.getPosition().column()];
+	this->searchOptions = options;
 }
 
-void Board::makeMove(const Move move)
+int Board::setTablebasePath(const std::string& paths)
 {
-	Position initialPosition = move.getInitialPosition();
-	Position targetPosition = move.getTargetPosition();
+	this->tablebases->setPath(paths);
+	return this->tablebases->maxPieces();
+}
 
-	// Check if the move is a castle
-	if (initialPosition == this->whiteKingPosition && !this->getPiece(initialPosition).hasMoved())
+bool Board::setEvalFile(const std::string& path)
+{
+	std::shared_ptr<Nnue> newNetwork;
+	bool loaded = true;
+	if (!path.empty() && path != "<empty>")
 	{
-		if (targetPosition == Position(7, 6) || targetPosition == Position(7, 2))
-		{
-			this->castle(move);
-			return;
-		}
+		newNetwork = std::make_shared<Nnue>();
+		loaded = newNetwork->load(path);
+		if (!loaded)
+			newNetwork.reset();
 	}
-	else if (initialPosition == this->blackKingPosition && !this->getPiece(initialPosition).hasMoved())
+
+	// Undo the moves of the history so the hidden layer of every position can be computed again by making them
+	std::vector<Move> moves;
+	while (this->historySize > 0)
 	{
-		if (targetPosition == Position(0, 6) || targetPosition == Position(0, 2))
-		{
-			this->castle(move);
-			return;
-		}
+		moves.push_back(this->undoHistory[this->historySize - 1].move);
+		if (moves.back() == Move())
+			this->undoNullMove();
+		else
+			this->undoMove();
 	}
 
-	// Check if the move is an en passant move
-	if (this->getPiece(initialPosition).getType() == Piece::Type::PAWN && this->getPiece(targetPosition).getType() == Piece::Type::NONE)
+	this->network = newNetwork;
+	this->accumulators.clear();
+	if (this->network)
 	{
-		if (targetPosition.column() != initialPosition.column()) // Check if the pawn moves diagonally
-		{
-			this->enPassant(move);
-			return;
-		}
+		this->accumulators.resize(maxHistorySize + 1);
+		this->network->resetAccumulator(this->accumulators[0]);
+		for (Square square = 0; square < 64; square++)
+			if (this->mailbox[square].getType() != Piece::Type::NONE)
+				this->network->updateAccumulator(this->accumulators[0], this->mailbox[square], square, 1);
 	}
 
-	Piece pieceToMove = this->board[initialPosition.row()][initialPosition.column()];
-	Piece pieceToGetCaptured = this->board[targetPosition.row()][targetPosition.column()];
-
-	// If the target square is occupied by another piece, then remove it
-	if (pieceToGetCaptured.getType() != Piece::Type::NONE)
+	// The moves fit in the history they came from, a move that can not be made again ends the replay where the board is still consistent
+	for (auto move = moves.rbegin(); move != moves.rend(); ++move)
 	{
-		this->removePiece(pieceToGetCaptured);
-		this->applyChangeToZobristHash(pieceToGetCaptured);
+		bool made = *move == Move() ? this->makeNullMove() : this->makeMove(*move);
+		if (!made)
+			break;
 	}
 
-	// Remove the piece to move from its square
-	this->removePiece(pieceToMove);
-	this->applyChangeToZobristHash(pieceToMove);
+	return loaded;
+}
 
-	// Add the piece to move to the target square
-	Piece movedPiece = Piece(pieceToMove.getType(), pieceToMove.getColor(), targetPosition, true); // Get a new piece with correct position and hasMoved
-	if (move.getPromotionType() != Piece::Type::NONE && pieceToMove.getType() == Piece::Type::PAWN) // Check if the move is a pawn promotion
-		movedPiece.setType(move.getPromotionType());
-	this->addPiece(movedPiece);
-	this->applyChangeToZobristHash(movedPiece);
+bool Board::canProbeTablebases() const
+{
+	int maxPieces = this->tablebases->maxPieces();
+	return maxPieces > 0 && this->getPieceCount() <= maxPieces && this->castlingRights() == 0;
+}
 
-	// Add a separator to the stack to mark the end of the move
-	this->actionsMade.push(Action::SEPARATOR);
+void Board::setThreadCount(const int newThreadCount)
+{
+	this->threadCount = std::max(1, newThreadCount);
 }
 
-void Board::undoMove()
+Move Board::iterativeDeepening(const int startDepth, const bool mainThread)
 {
-	if (this->actionsMade.empty())
-		return;
+	Move result = Move();
+	this->bestMoveForPreviousDepth = Move();
 
-	// Pop the separator
-	if (this->actionsMade.top() == Action::SEPARATOR)
-		this->actionsMade.pop();
-	
-	while (!this->actionsMade.empty())
-	{
-		Action action = this->actionsMade.top();
-		if (action == Action::SEPARATOR) // The undo is complete, leave a separator on top of stack
-			break;
+	// Forget the move ordering information of the previous search
+	this->rootHistorySize = this->historySize;
+	for (int ply = 0; ply <= maxSearchDepth; ply++)
+		this->killerMoves[ply][0] = this->killerMoves[ply][1] = Move();
+	std::fill(&this->historyTable[0][0][0], &this->historyTable[0][0][0] + 2 * 64 * 64, 0);
+
+	// Time at the start of the search and of the current depth
+	auto start = std::chrono::high_resolution_clock::now();
+	auto depthStart = start;
+
+	int depthLimit = maxSearchDepth;
+	if (this->searchController->depthLimit() > 0 && this->searchController->depthLimit() < maxSearchDepth)
+		depthLimit = this->searchController->depthLimit();
+
+	// The score of the last completed depth
+	int previousScore = 0;
 
-		// Remove action from stack
-		this->actionsMade.pop();
+	// Search until the depth limit has been reached or until notified the time limit has exceeded
+	for (int depth = startDepth; depth <= depthLimit && !this->searchStopped && !this->searchController->isStopped(); depth++)
+	{
+		// Search with a narrow window around the score of the previous depth and widen it on the side the score fell out of until it falls inside
+		int delta = aspirationWindow;
+		int alpha = -infinityValue, beta = infinityValue;
+		if (depth >= 4 && previousScore > -mateThreshold && previousScore < mateThreshold)
+		{
+			alpha = previousScore - delta;
+			beta = previousScore + delta;
+		}
 
-		if (action == Action::REMOVE_PIECE)
+		auto possibleResult = this->negamax(depth, alpha, beta);
+		while (!this->searchStopped && (possibleResult.value <= alpha || possibleResult.value >= beta))
 		{
-			// Get the last removed piece
-			Piece removedPiece = this->removedPieces.top();
-			this->removedPieces.pop();
+			delta *= 2;
+			if (possibleResult.value <= alpha)
+				alpha = delta > 500 ? -infinityValue : std::max(possibleResult.value - delta, -infinityValue);
+			else
+				beta = delta > 500 ? infinityValue : std::min(possibleResult.value + delta, (int)infinityValue);
 
-			// Add the piece back with silent = true to avoid modifying the helper stacks
-			this->addPiece(removedPiece, true);
-			this->applyChangeToZobristHash(removedPiece);
+			possibleResult = this->negamax(depth, alpha, beta);
 		}
-		else if (action == Action::ADD_PIECE)
+
+		// Check if the minimax search was stopped abruptly (a search that was stopped after it completed is still complete)
+		if (!this->searchStopped)
 		{
-			// Get the last added piece
-			Piece addedPiece = this->addedPieces.top();
-			this->addedPieces.pop();
+			// If not then store the result
+			result = possibleResult.move;
+			previousScore = possibleResult.value;
+			this->bestMoveForPreviousDepth = result;
 
-			// Remove the piece with silent = true to avoid modifying the helper stacks
-			this->removePiece(addedPiece, true);
-			this->applyChangeToZobristHash(addedPiece);
+			// Report the completed depth with the score from the point of view of the player to move
+			if (mainThread)
+			{
+				auto stop = std::chrono::high_resolution_clock::now();
+				int64_t milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start).count();
+				int64_t depthTime = std::chrono::duration_cast<std::chrono::milliseconds>(stop - depthStart).count();
+				depthStart = stop;
+
+				uint64_t nodes = this->searchController->nodes() + this->pendingNodes;
+				int score = possibleResult.value;
+
+				// Mate scores are reported in moves (negative if the player to move gets mated)
+				std::string scoreString = "cp " + std::to_string(score);
+				if (score >= mateThreshold)
+					scoreString = "mate " + std::to_string((mateValue - score + 1) / 2);
+				else if (score <= -mateThreshold)
+					scoreString = "mate " + std::to_string(-(mateValue + score) / 2);
+
+				std::string info = "info depth " + std::to_string(depth) + " score " + scoreString +
+					" nodes " + std::to_string(nodes) + " nps " + std::to_string(nodes * 1000 / (milliseconds > 0 ? milliseconds : 1)) +
+					" time " + std::to_string(milliseconds) + (result == Move() ? "" : " pv " + result.toAlgebraicString()) + "\n";
+				std::cout << info << std::flush;
+
+				// Stop if the player to move has no legal moves or if the time manager decides another depth is not worth starting
+				if (result == Move() || this->timeManager.completedDepth(result, score, depthTime))
+					break;
+			}
 		}
 	}
+
+	// Notify that the search has stopped (the helper threads stop when the main thread does),
+	// an infinite search that ran out of depths, found a mate or has no legal move still waits for the stop command before the best move is sent
+	if (mainThread)
+	{
+		if (this->searchController->isInfinite())
+			this->searchController->waitForStop();
+		this->searchController->stop();
+	}
+
+	return result;
 }
 
-// Compute the value of the current state of the board (positive values are better for white and negative values are better for black)
-int Board::evaluate() const
+// Convert a score relative to the current node into one relative to the stored position (mate scores are stored as the distance from the position instead of the root)
+static int valueToTable(const int value, const int ply, const int mateThreshold)
 {
-	return this->evaluation;
+	if (value >= mateThreshold)
+		return value + ply;
+	if (value <= -mateThreshold)
+		return value - ply;
+	return value;
 }
 
-Move Board::getBestMove(const Piece::Color playerToMove)
+// Convert a score read from the transposition table back into one relative to the root
+static int valueFromTable(const int value, const int ply, const int mateThreshold)
 {
-	Move result = Move();
-	this->bestMoveForPreviousDepth = Move();
-	this->stopSearch.store(false);
+	if (value >= mateThreshold)
+		return value - ply;
+	if (value <= -mateThreshold)
+		return value + ply;
+	return value;
+}
 
-	// Function for the search thread
-	auto searchForBestMove = [this](const Piece::Color playerToMove, Move& result)
-		{
-			// Time at the start of the search
-			auto start = std::chrono::high_resolution_clock::now();
+Board::minimaxResult Board::negamax(int depth, int alpha, int beta)
+{
+	this->countNode();
 
-			// Search until the depth limit has been reached or until notified the time limit has exceeded
-			for (int depth = 1; depth <= maxSearchDepth && !this->stopSearch.load(); depth++)
-			{
-				// Store the result from the minimax algorith for the current depth
-				auto possibleResult = this->minimax(depth, INT_MIN, INT_MAX, playerToMove == Piece::Color::WHITE).move;
-
-				// Check if the minimax search was stopped abruptly because of the time limit
-				if (!this->stopSearch.load())
-				{
-					// If not then store the result
-					result = possibleResult;
-					this->bestMoveForPreviousDepth = result;
-
-					// Compute time to search to current depth and display it
-					auto stop = std::chrono::high_resolution_clock::now();
-					auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
-					std::cout << "Depth " << depth << " reached in " << duration.count() << "ms\n";
-				}
-			}
+	// Check if the search should be stopped
+	if (this->searchStopped)
+		return Board::minimaxResult(Move(), 0);
+
+	Piece::Color currentPlayer = this->sideToMove;
+	int ply = this->historySize - this->rootHistorySize;
+	int originalAlpha = alpha;
 
-			// Notify that the search has stopped
-			this->stopSearch.store(true);
-		};
+	// Without room in the undo history for another move the static evaluation has to do (like in the quiescence search)
+	if (this->historySize >= maxHistorySize - 1)
+		return Board::minimaxResult(Move(), currentPlayer == Piece::Color::WHITE ? this->evaluate() : -this->evaluate());
 
-	// Start a new thread that runs the search
-	std::thread searchThread(searchForBestMove, playerToMove, std::ref(result));
-	
-	// Wait for the other thread to search the best move until the time limit is exceeded
-	auto start = std::chrono::high_resolution_clock::now();
-	while (std::chrono::duration_cast<std::chrono::seconds>(std::chrono::high_resolution_clock::now() - start).count() < searchTime)
+	if (ply > 0)
 	{
-		// If the search has already reached the depth limit then stop waiting
-		if (this->stopSearch.load())
-			break;
+		// Mate distance pruning: no line from here can be better than mating on the next move or worse than being mated now
+		if (alpha < -mateValue + ply)
+			alpha = -mateValue + ply;
+		if (beta > mateValue - ply - 1)
+			beta = mateValue - ply - 1;
+		if (alpha >= beta)
+			return Board::minimaxResult(Move(), alpha);
+	}
+
+	// Check if the move for this board state has already been computed
+	TranspositionTable::Entry tableEntry;
+	bool tableHit = this->transpositionTable->probe(this->zobristHash, tableEntry);
+	int tableValue = tableHit ? valueFromTable(tableEntry.evaluation, ply, mateThreshold) : 0;
 
-		// Sleep for a very short amount of time
-		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	// The root is always searched so every depth of a search reports a real result
+	if (tableHit && tableEntry.depth >= depth && ply > 0)
+	{
+		if (tableEntry.bound == TranspositionTable::Bound::EXACT ||
+			(tableEntry.bound == TranspositionTable::Bound::LOWER && tableValue >= beta) ||
+			(tableEntry.bound == TranspositionTable::Bound::UPPER && tableValue <= alpha))
+		{
+			// The stored result is exact or a bound that is already outside the search window
+			return Board::minimaxResult(tableEntry.move, tableValue);
+		}
 	}
 
-	// Notify the other thread to stop the search once the time limit is exceeded
-	this->stopSearch.store(true);
+	// Resolve the captures at the horizon so the position is not evaluated in the middle of an exchange
+	if (depth <= 0 || ply >= maxSearchDepth)
+		return Board::minimaxResult(Move(), this->quiescence(alpha, beta));
 
-	searchThread.join();
+	// Positions in the tablebases have a known result, they are only probed right after a capture or pawn move (the stored result ignores the moves already played towards the fifty move rule)
+	if (ply > 0 && this->halfmoveClock == 0 && this->canProbeTablebases())
+	{
+		Tablebases::Wdl wdl;
+		if (this->tablebases->probeWdl(*this, wdl))
+		{
+			// Wins are worth less the further they are from the root so the search heads for the closest one
+			int value = wdl == Tablebases::Wdl::WIN ? tablebaseWinValue - ply : wdl == Tablebases::Wdl::LOSS ? -tablebaseWinValue + ply : (int)wdl;
+			TranspositionTable::Bound bound = wdl == Tablebases::Wdl::WIN ? TranspositionTable::Bound::LOWER :
+				wdl == Tablebases::Wdl::LOSS ? TranspositionTable::Bound::UPPER : TranspositionTable::Bound::EXACT;
 
-	return result;
-}
+			if (bound == TranspositionTable::Bound::EXACT || (bound == TranspositionTable::Bound::LOWER && value >= beta) || (bound == TranspositionTable::Bound::UPPER && value <= alpha))
+			{
+				this->transpositionTable->store(this->zobristHash, TranspositionTable::Entry(Move(), std::min(depth + 6, maxSearchDepth - 1), value, bound));
+				return Board::minimaxResult(Move(), value);
+			}
+		}
+	}
 
-Board::minimaxResult Board::minimax(int depth, int alpha, int beta, const bool whiteToMove)
-{
-	// Check if the search should be stopped
-	if (this->stopSearch.load())
-		return Board::minimaxResult(Move(), 0);
+	bool pvNode = beta - alpha > 1;
+	bool inCheck = this->isInCheck(currentPlayer);
+	int staticEvaluation = currentPlayer == Piece::Color::WHITE ? this->evaluate() : -this->evaluate();
 
-	// Check if the move for this board state has already been computed
-	if (this->transpositionTable[this->getZobristHash()].depth >= depth)
+	// Reverse futility pruning: near the leaves a position far above beta is very unlikely to fall below it
+	if (this->searchOptions.reverseFutilityPruning && !pvNode && !inCheck && depth <= reverseFutilityMaximumDepth &&
+		beta > -mateThreshold && beta < mateThreshold && staticEvaluation - reverseFutilityMargin * depth >= beta)
+		return Board::minimaxResult(Move(), staticEvaluation);
+
+	// Null move pruning: if the opponent can not reach beta even after a free move then a real move will not let them either
+	// (not done twice in a row and not without pieces other than pawns, where passing the turn can be better than any move)
+	bool previousMoveWasNull = this->historySize > 0 && this->undoHistory[this->historySize - 1].move == Move();
+	if (this->searchOptions.nullMovePruning && !pvNode && !inCheck && !previousMoveWasNull && ply > 0 &&
+		depth >= nullMoveMinimumDepth && staticEvaluation >= beta && this->hasNonPawnMaterial(currentPlayer))
 	{
-		Board::TranspositionTableEntry tableEntry = this->transpositionTable[this->getZobristHash()];
+		int reduction = 3 + depth / 6;
 
-		// Check if the result of the move stored in the transposition table is exact or not (if not continue the search)
-		if (tableEntry.exact)
+		// Without room in the undo history for the null move the position is simply searched without it
+		if (this->makeNullMove())
 		{
-			Piece::Color currentPlayer = whiteToMove ? Piece::Color::WHITE : Piece::Color::BLACK;
-			if (this->isValid(tableEntry.move, currentPlayer))
-				return Board::minimaxResult(tableEntry.move, tableEntry.evaluation, tableEntry.exact);
+			int value = -this->negamax(depth - 1 - reduction, -beta, -beta + 1).value;
+			this->undoNullMove();
+
+			if (this->searchStopped)
+				return Board::minimaxResult(Move(), 0);
+
+			// Mate scores found after passing the turn are not trusted
+			if (value >= beta)
+				return Board::minimaxResult(Move(), value >= mateThreshold ? beta : value);
 		}
 	}
 
+	// Futility pruning: near the leaves quiet moves can not bring a position far below alpha back up to it
+	bool futile = this->searchOptions.futilityPruning && !pvNode && !inCheck && depth <= futilityMaximumDepth &&
+		alpha > -mateThreshold && alpha < mateThreshold && staticEvaluation + futilityMargin * depth <= alpha;
+
 	// Get all the possible moves of the current player
-	std::vector<Move> moves = this->getMoves(whiteToMove ? Piece::Color::WHITE : Piece::Color::BLACK);
+	MoveList moves;
+	this->getMoves(currentPlayer, moves);
 
-	// Get the current state of the game
-	GameState gameState = this->getGameState(whiteToMove ? Piece::Color::WHITE : Piece::Color::BLACK, moves);
-	
-	// Check for checkmate
-	if (gameState == GameState::CHECKMATE) // TODO Choose the fastest mate
-		return whiteToMove ? Board::minimaxResult(Move(), INT_MIN + 1) : Board::minimaxResult(Move(), INT_MAX - 1);
-	
-	// Check for stalemate
-	if (gameState == GameState::STALEMATE)
-		return Board::minimaxResult(Move(), 0);
+	// Search the move from the transposition table first (or the best move from the previous depth at the root)
+	Move hashMove = ply == 0 ? this->bestMoveForPreviousDepth : (tableHit ? tableEntry.move : Move());
+	MovePicker movePicker(*this, moves, hashMove, this->killerMoves[ply], this->historyTable[getColorIndex(currentPlayer)]);
+	Move move;
 
-	if (depth == 0)
-		return Board::minimaxResult(Move(), this->evaluate());
+	// Without legal moves the game is over: checkmate (scored by the distance from the root so faster mates are preferred) or stalemate
+	if (moves.empty())
+		return Board::minimaxResult(Move(), inCheck ? -mateValue + ply : 0);
 
-	int originalAlpha = alpha;
+	Board::minimaxResult result(Move(), -infinityValue);
+	int movesSearched = 0;
 
-	if (whiteToMove)
+	while (movePicker.next(move))
 	{
-		// Initialize the result with an empty move and the smallest possible value
-		Board::minimaxResult result(Move(), INT_MIN);
+		// Near the leaves skip the captures that lose a lot of material once a move has been searched to fall back on
+		if (this->searchOptions.staticExchangePruning && !pvNode && !inCheck && depth <= staticExchangeMaximumDepth && movesSearched > 0 &&
+			movePicker.handingOutLosingCaptures() && this->staticExchangeEvaluation(move) < -staticExchangeMargin * depth)
+			continue;
 
-		// Reset the best move from the previous depth if we already used it to avoid affecting move generation at deeper game tree levels
-		if (!moves.empty() && moves.front() == this->bestMoveForPreviousDepth)
-			this->bestMoveForPreviousDepth = Move();
+		bool quiet = this->isQuietMove(move);
+		bool killer = move == this->killerMoves[ply][0] || move == this->killerMoves[ply][1];
+		bool givesCheck = this->givesCheck(move);
 
-		for (Move move : moves)
-		{
-			// Check if the search should be stopped before making the current move
-			if (this->stopSearch.load())
-				return Board::minimaxResult(Move(), 0);
+		// Skip the futile quiet moves once a move has been searched to fall back on
+		if (futile && quiet && !givesCheck && movesSearched > 0)
+			continue;
+
+		this->makeMove(move); // Make the current move and change the player
 
-			this->makeMove(move); // Make the current move
-			this->passTheTurn(); // Change the player
+		movesSearched++;
 
-			if (!this->isInCheck(Piece::Color::WHITE)) // Check if the move is valid
+		// Principal variation search: the first move is searched with the full window and the others with a null window that only proves they are not better,
+		// a move that turns out to be better is searched again with the full window
+		int value;
+		if (movesSearched == 1)
+		{
+			value = -this->negamax(depth - 1, -beta, -alpha).value;
+		}
+		else
+		{
+			// Late move reductions: quiet moves ordered late are probably bad so they are first searched with a smaller depth
+			int reduction = 0;
+			if (this->searchOptions.lateMoveReductions && depth >= reductionMinimumDepth && movesSearched > 3 && quiet && !killer && !inCheck && !givesCheck)
 			{
-				Board::minimaxResult child = this->minimax(depth - 1, alpha, beta, false); // Evaluate the result of the current move and go deeper in the recursion tree
-				if (child.value > result.value) // If the current result is better then store it
-				{
-					result.move = move;
-					result.value = child.value;
-				}
-				alpha = std::max(alpha, child.value);
+				reduction = 1 + (movesSearched > 8 ? 1 : 0) + (depth > 8 ? 1 : 0) - (pvNode ? 1 : 0);
+				if (reduction > depth - 2)
+					reduction = depth - 2;
 			}
 
-			this->undoMove(); // Undo the current move to bring the table back to its original state
-			this->passTheTurn(); // Return to the original player
+			value = -this->negamax(depth - 1 - reduction, -alpha - 1, -alpha).value;
 
-			if (beta <= alpha)
-				break;
+			// A reduced move that beats alpha is searched again with the full depth
+			if (reduction > 0 && value > alpha)
+				value = -this->negamax(depth - 1, -alpha - 1, -alpha).value;
+
+			if (value > alpha && value < beta)
+				value = -this->negamax(depth - 1, -beta, -alpha).value;
 		}
 
+		this->undoMove(); // Undo the current move to bring the table back to its original state and return to the original player
+
 		// Check if the search should be stopped
-		if (this->stopSearch.load())
+		if (this->searchStopped)
 			return Board::minimaxResult(Move(), 0);
 
-		// Store the found move in the transposition table
-		if (depth >= this->transpositionTable[this->getZobristHash()].depth)
-			this->transpositionTable[this->getZobristHash()] = Board::TranspositionTableEntry(result.move, depth, result.value, result.exact);
+		if (value > result.value) // If the current result is better then store it
+		{
+			result.move = move;
+			result.value = value;
+
+			if (value > alpha)
+				alpha = value;
 
-		// Return the result
-		return result;
+			if (alpha >= beta)
+			{
+				this->storeCutoffMove(move, currentPlayer, depth);
+				break;
+			}
+		}
 	}
-	else
-	{
-		// Initialize the result with an empty move and the biggest possible value
-		Board::minimaxResult result(Move(), INT_MAX);
 
-		// Reset the best move from the previous depth if we already used it to avoid affecting move generation at deeper game tree levels
-		if (!moves.empty() && moves.front() == this->bestMoveForPreviousDepth)
-			this->bestMoveForPreviousDepth = Move();
+	// Store the found move in the transposition table with the kind of bound the result is
+	TranspositionTable::Bound bound = TranspositionTable::Bound::EXACT;
+	if (result.value <= originalAlpha)
+		bound = TranspositionTable::Bound::UPPER;
+	else if (result.value >= beta)
+		bound = TranspositionTable::Bound::LOWER;
+	this->transpositionTable->store(this->zobristHash, TranspositionTable::Entry(result.move, depth, valueToTable(result.value, ply, mateThreshold), bound));
 
-		for (Move move : moves)
-		{
-			// Check if the search should be stopped before making the current move
-			if (this->stopSearch.load())
-				return Board::minimaxResult(Move(), 0);
+	return result;
+}
 
-			this->makeMove(move); // Make the current move
-			this->passTheTurn(); // Change the player
+bool Board::makeNullMove()
+{
+	if (this->historySize >= maxHistorySize)
+		return false;
 
-			if (!this->isInCheck(Piece::Color::BLACK)) // Check if the move is valid
-			{
-				Board::minimaxResult child = this->minimax(depth - 1, alpha, beta, true); // Evaluate the result of the current move and go deeper in recursion tree
-				if (child.value < result.value) // If the current result is better then store it
-				{
-					result.move = move;
-					result.value = child.value;
-				}
-				beta = std::min(beta, child.value);
-			}
+	// Store everything needed to undo the null move (the empty move marks it in the history)
+	UndoRecord& record = this->undoHistory[this->historySize++];
+	record.move = Move();
+	record.movedPieceType = Piece::Type::NONE;
+	record.capturedPiece = Piece();
+	record.castlingRights = this->castling;
+	record.enPassantSquare = this->enPassantSquare;
+	record.halfmoveClock = this->halfmoveClock;
+	record.zobristHash = this->zobristHash;
+	record.pawnHash = this->pawnHash;
+	record.middlegameEvaluation = this->middlegameEvaluation;
+	record.endgameEvaluation = this->endgameEvaluation;
+	record.gamePhase = this->gamePhase;
+
+	if (this->network)
+		this->accumulators[this->historySize] = this->accumulators[this->historySize - 1];
+
+	if (this->enPassantSquare != -1)
+		this->zobristHash ^= zobristKeys.enPassant[this->enPassantSquare & 7];
+	this->enPassantSquare = -1;
+	this->halfmoveClock++;
+	this->passTheTurn();
+
+	return true;
+}
+
+void Board::undoNullMove()
+{
+	const UndoRecord& record = this->undoHistory[--this->historySize];
+
+	this->enPassantSquare = record.enPassantSquare;
+	this->halfmoveClock = record.halfmoveClock;
+	this->zobristHash = record.zobristHash;
+	this->sideToMove = this->sideToMove == Piece::Color::WHITE ? Piece::Color::BLACK : Piece::Color::WHITE;
+}
+
+bool Board::hasNonPawnMaterial(const Piece::Color color) const
+{
+	Bitboard pieces = this->pieceBitboards[Piece::Type::BISHOP] | this->pieceBitboards[Piece::Type::KNIGHT] | this->pieceBitboards[Piece::Type::ROOK] | this->pieceBitboards[Piece::Type::QUEEN];
+	return (pieces & this->colorBitboards[getColorIndex(color)]) != 0;
+}
+
+int Board::quiescence(int alpha, int beta)
+{
+	this->countNode();
+
+	if (this->searchStopped)
+		return 0;
+
+	Piece::Color currentPlayer = this->sideToMove;
+	int sign = currentPlayer == Piece::Color::WHITE ? 1 : -1;
+
+	// The player to move does not have to capture, so the static evaluation is a lower bound (stand pat)
+	int standPat = sign * this->evaluate();
+	if (standPat >= beta || this->historySize >= maxHistorySize - 1)
+		return standPat;
+	if (standPat > alpha)
+		alpha = standPat;
+
+	MoveList moves;
+	this->getCaptures(currentPlayer, moves);
+
+	// Captures are ordered by MVV-LVA and there are no killer moves in the quiescence search
+	const Move noKillers[2] = { Move(), Move() };
+	MovePicker movePicker(*this, moves, Move(), noKillers, this->historyTable[getColorIndex(currentPlayer)]);
+	Move move;
+
+	int bestValue = standPat;
+	while (movePicker.next(move))
+	{
+		// The captures that lose material are handed out last and can not raise the evaluation above the stand pat
+		if (this->searchOptions.staticExchangePruning && movePicker.handingOutLosingCaptures())
+			break;
+
+		// Delta pruning: skip captures that can not bring the evaluation back to alpha even with a margin for the positional gain
+		if (move.getFlag() != Move::Flag::PROMOTION)
+		{
+			int capturedValue = move.getFlag() == Move::Flag::EN_PASSANT ? pieceValue[Piece::Type::PAWN] : pieceValue[this->getPiece(move.getTargetSquare()).getType()];
+			if (standPat + capturedValue + deltaMargin <= alpha)
+				continue;
+		}
+
+		this->makeMove(move);
+		int value = -this->quiescence(-beta, -alpha);
+		this->undoMove();
 
-			this->undoMove(); // Undo the current move to bring the table back to its original state
-			this->passTheTurn(); // Return to the original player
+		if (this->searchStopped)
+			return 0;
 
-			if (beta <= alpha)
+		if (value > bestValue)
+		{
+			bestValue = value;
+			if (value > alpha)
+				alpha = value;
+			if (alpha >= beta)
 				break;
 		}
+	}
 
-		// Check if the search should be stopped
-		if (this->stopSearch.load())
-			return Board::minimaxResult(Move(), 0);
+	return bestValue;
+}
 
-		if (originalAlpha < result.value && result.value < beta)
-			result.exact = true;
-		else
-			result.exact = false;
+void Board::storeCutoffMove(const Move move, const Piece::Color color, const int depth)
+{
+	// Captures and promotions are already ordered first
+	if (!this->isQuietMove(move))
+		return;
 
-		// Store the found move in the transposition table
-		if (depth >= this->transpositionTable[this->getZobristHash()].depth)
-			this->transpositionTable[this->getZobristHash()] = Board::TranspositionTableEntry(result.move, depth, result.value, result.exact);
+	int ply = this->historySize - this->rootHistorySize;
+	if (ply > maxSearchDepth)
+		ply = maxSearchDepth;
 
-		// Return the result
-		return result;
+	// Keep the two most recent killer moves of this distance from the root
+	if (!(this->killerMoves[ply][0] == move))
+	{
+		this->killerMoves[ply][1] = this->killerMoves[ply][0];
+		this->killerMoves[ply][0] = move;
 	}
+
+	// Cutoffs closer to the root are worth more
+	this->historyTable[getColorIndex(color)][move.getInitialSquare()][move.getTargetSquare()] += depth * depth;
 }
 
 std::string Board::toString() const
@@ -1679,7 +1742,7 @@ std::string Board::toString() const
 	for (int i = 0; i < 8; i++)
 	{
 		for (int j = 0; j < 8; j++)
-			switch (this->board[i][j].getType())
+			switch (this->getPiece(squareIndex(i, j)).getType())
 			{
 			case Piece::Type::PAWN:
 				boardString += "P";
@@ -1717,7 +1780,7 @@ std::string Board::attackedSquaresToString(const Piece::Color color) const
 	for (int i = 0; i < 8; i++)
 	{
 		for (int j = 0; j < 8; j++)
-			if (this->isAttackedBy(Position(i, j), color))
+			if (this->isAttackedBy(squareIndex(i, j), color))
 				boardString += "X";
 			else
 				boardString += "O";
@@ -1728,8 +1791,6 @@ std::string Board::attackedSquaresToString(const Piece::Color color) const
 	return boardString;
 }
 
-Board::minimaxResult::minimaxResult(const Move move, const int value, const int exact) : move(move), value(value), exact(exact) {}
-
-Board::TranspositionTableEntry::TranspositionTableEntry() : move(Move()), depth(0), evaluation(0), exact(false) {}
+Board::minimaxResult::minimaxResult(const Move move, const int value) : move(move), value(value) {}
 
-Board::TranspositionTableEntry::TranspositionTableEntry(const Move move, const int depth, const int evaluation, const int exact) : move(move), depth(depth), evaluation(evaluation), exact(exact) {}
+Board::SearchOptions::SearchOptions() : nullMovePruning(true), lateMoveReductions(true), reverseFutilityPruning(true), futilityPruning(true), staticExchangePruning(true) {}
@@ -1,124 +1,164 @@
 #pragma once
 #include <vector>
-#include <stack>
-#include <set>
 #include <string>
 #include <atomic>
+#include <memory>
+#include <cstdint>
 #include "Piece.h"
 #include "Move.h"
+#include "MoveList.h"
+#include "MovePicker.h"
+#include "TranspositionTable.h"
+#include "SearchLimits.h"
+#include "SearchController.h"
+#include "TimeManager.h"
+#include "Bitboard.h"
+#include "Nnue.h"
+#include "PawnHashTable.h"
+
+class Tablebases;
 
 class Board
 {
+public:
+	// Selective search techniques that can be turned off to compare the search with and without them
+	class SearchOptions
+	{
+	public:
+		// Skip the turn with a reduced depth and prune the node if the opponent still can not reach beta
+		bool nullMovePruning;
+		// Search the quiet moves that come late in the move ordering with a reduced depth
+		bool lateMoveReductions;
+		// Prune nodes near the leaves whose static evaluation is far above beta
+		bool reverseFutilityPruning;
+		// Skip quiet moves near the leaves when the static evaluation is far below alpha
+		bool futilityPruning;
+		// Skip the captures that lose material by the static exchange evaluation in the quiescence search and near the leaves
+		bool staticExchangePruning;
+		// Construct search options with every technique turned on
+		SearchOptions();
+	};
+
 private:
 	class minimaxResult
 	{
 	public:
-		// The move returned by the minimax algorithm
+		// The move returned by the search
 		Move move;
-		// The evaluation value return by the minimax algorithm
+		// The evaluation value returned by the search (from the point of view of the player to move)
 		int value;
-		// Bool value that indicates the type of node that will be stored in the transposition table
-		bool exact;
-		// Construct a minimax result given a move and an evaluation value
-		minimaxResult(const Move move, const int value, const int exact = true);
+		// Construct a search result given a move and an evaluation value
+		minimaxResult(const Move move, const int value);
 	};
 
-	class TranspositionTableEntry
+	class UndoRecord
 	{
 	public:
-		// The stored move (the best move found so far for the state the board is in)
+		// The move that was made
 		Move move;
-		// The depth of the search that found the stored move
-		int depth;
-		// The evaluation of the board corresponding to the stored move
-		int evaluation;
-		// Bool value that indicates the type of node stored in the transposition table
-		bool exact;
-		// Construct an empty transposition table entry
-		TranspositionTableEntry();
-		// Construct a transposition table entry given a move and a depth
-		TranspositionTableEntry(const Move move, const int depth, const int evaluation, const int exact);
+		// The type of the piece that was moved (before a possible promotion)
+		Piece::Type movedPieceType;
+		// The piece captured by the move (an empty piece if nothing was captured, the pawn captured en passant is not on the target square)
+		Piece capturedPiece;
+		// The castling rights before the move
+		int castlingRights;
+		// The en passant square before the move
+		int enPassantSquare;
+		// The number of half moves since the last capture or pawn move before the move
+		int halfmoveClock;
+		// The zobrist hash and the pawn hash before the move
+		uint64_t zobristHash;
+		uint64_t pawnHash;
+		// The middle game and end game evaluations and the game phase before the move
+		int middlegameEvaluation;
+		int endgameEvaluation;
+		int gamePhase;
 	};
 
-	// Enum for all possible actions performed on the board
-	enum Action
-	{
-		SEPARATOR = 0,
-		REMOVE_PIECE = 1,
-		ADD_PIECE = 2,
-	};
+	// Bitboards that contain the squares occupied by each type of piece (indexed by Piece::Type, index 0 is unused)
+	Bitboard pieceBitboards[7];
 
-	// Enum for all possible game states
-	enum GameState
-	{
-		UNFINISHED = 0,
-		CHECKMATE = 1,
-		STALEMATE = 2
-	};
+	// Bitboards that contain the squares occupied by each color (index 0 for white, index 1 for black)
+	Bitboard colorBitboards[2];
 
-	// Array that represents the current state of the board
-	Piece board[8][8];
+	// The piece on every square (an empty piece on empty squares), kept together with the bitboards so finding the piece on a square is a single load
+	Piece mailbox[64];
 
-	// Two sets that contain the occupied squares of each color (index 0 for white, index 1 for black)
-	std::set<Position> occupiedSquares[2];
+	// Castling rights of both players as bits (1 white kingside, 2 white queenside, 4 black kingside, 8 black queenside)
+	int castling;
 
+	// Get a bitboard with all the occupied squares
+	Bitboard occupiedSquares() const;
 
-	// Stack that keeps track of all actions made (used for reverting them)
-	std::stack<Action> actionsMade;
+	// Get the index of the square of the king of the given color
+	Square kingSquare(const Piece::Color color) const;
 
-	// Helper stack that keeps track of added pieces
-	std::stack<Piece> addedPieces;
+	// Index of the square a pawn can capture en passant on (-1 if the last move was not a pawn moving two squares)
+	int enPassantSquare;
 
-	// Helper stack that keeps track of removed pieces
-	std::stack<Piece> removedPieces;
+	// The color of the player whose turn it is
+	Piece::Color sideToMove;
 
+	// The number of half moves since the last capture or pawn move (used for the fifty move rule)
+	int halfmoveClock;
 
-	// The position of the white king
-	Position whiteKingPosition;
+	// The number of the current full move (starts at 1 and grows after every move of black)
+	int fullmoveNumber;
 
-	// The position of the black king
-	Position blackKingPosition;
 
+	// The maximum number of moves that can be made on the board without undoing them (game moves and search moves)
+	static const int maxHistorySize = 2048;
 
-	// Check if any piece of the given color can move to the given square assuming it has access to it (NOT SUITABLE FOR PAWNS)
-	bool availableSquare(const Piece::Color color, const int row, const int column) const;
+	// Records of all moves made that have not been undone (used for reverting them)
+	UndoRecord undoHistory[maxHistorySize];
 
-	// Add all possible moves of a piece in a direction to a container reference given as a parameter
-	void addAllMovesInDirection(std::vector<Move>& moves, const Piece piece, const int rowChange, const int columnChange) const;
+	// The number of records in the undo history
+	int historySize;
 
-	// Add all possible moves of a given pawn to a container reference given as a parameter
-	void addPawnMoves(std::vector<Move>& moves, const Piece piece) const;
 
-	// Add all possible moves of a given bishop to a container reference given as a parameter
-	void addBishopMoves(std::vector<Move>& moves, const Piece piece) const;
+	// Add a move from the given square to every square of the targets bitboard to a container reference given as a parameter
+	void addMovesToTargets(MoveList& moves, const Square initialSquare, Bitboard targets) const;
 
-	// Add all possible moves of a given knight to a container reference given as a parameter
-	void addKnightMoves(std::vector<Move>& moves, const Piece piece) const;
+	// Add all possible moves of the pawn of the given color on the given square to a container reference given as a parameter (only the captures and promotions if capturesOnly is true)
+	void addPawnMoves(MoveList& moves, const Square square, const Piece::Color color, const bool capturesOnly) const;
 
-	// Add all possible moves of a given rook to a container reference given as a parameter
-	void addRookMoves(std::vector<Move>& moves, const Piece piece) const;
+	// Add all possible moves of the bishop of the given color on the given square to a container reference given as a parameter (only the captures if capturesOnly is true)
+	void addBishopMoves(MoveList& moves, const Square square, const Piece::Color color, const bool capturesOnly) const;
 
-	// Add all possible moves of a given queen to a container reference given as a parameter
-	void addQueenMoves(std::vector<Move>& moves, const Piece piece) const;
+	// Add all possible moves of the knight of the given color on the given square to a container reference given as a parameter (only the captures if capturesOnly is true)
+	void addKnightMoves(MoveList& moves, const Square square, const Piece::Color color, const bool capturesOnly) const;
 
-	// Add all possible moves of a given king to a container reference given as a parameter
-	void addKingMoves(std::vector<Move>& moves, const Piece piece) const;
+	// Add all possible moves of the rook of the given color on the given square to a container reference given as a parameter (only the captures if capturesOnly is true)
+	void addRookMoves(MoveList& moves, const Square square, const Piece::Color color, const bool capturesOnly) const;
 
-	// Adds a given piece on the current board table, if silent = true then it does not update the addedPieces stack (useful for undo)
-	void addPiece(const Piece piece, const bool silent = false);
+	// Add all possible moves of the queen of the given color on the given square to a container reference given as a parameter (only the captures if capturesOnly is true)
+	void addQueenMoves(MoveList& moves, const Square square, const Piece::Color color, const bool capturesOnly) const;
 
-	// Removes a piece from the current board table, if silent = true then it does not update the removedPieces stack (useful for undo)
-	void removePiece(const Piece piece, const bool silent = false);
+	// Add all possible moves of the king of the given color on the given square to a container reference given as a parameter (only the captures if capturesOnly is true)
+	void addKingMoves(MoveList& moves, const Square square, const Piece::Color color, const bool capturesOnly) const;
 
-	
-	// Returns true if the given position is attacked by a piece of the other color, false otherwise
-	bool isAttackedBy(const Position position, const Piece::Color attackingColor) const;
+	// Fill the given move list with the legal moves of the given color (only the captures and promotions if capturesOnly is true),
+	// the checkers and pinned pieces are found once so no move has to be made to find out if it leaves the king in check
+	void generateMoves(const Piece::Color playerColor, MoveList& moves, const bool capturesOnly) const;
 
-	// Returns true if the king of given color is in check, false otherwise
-	bool isInCheck(const Piece::Color color) const;
+	// Get the pieces of both colors that attack the given square if the given squares were the occupied ones
+	Bitboard attackersTo(const Square square, const Bitboard occupied) const;
+
+	// Returns true if the given en passant capture does not leave the king on the given square in check (the capture removes two pieces from the same row)
+	bool isLegalEnPassant(const Move move, const Square kingSquare) const;
+
+	// Adds a given piece on the given square and updates the evaluation
+	void addPiece(const Piece piece, const Square square);
 
-	// Returns true if the player of the given color is checkmated, false otherwise
-	GameState getGameState(const Piece::Color color, const std::vector<Move>& possibleMoves);
+	// Removes the piece on the given square and updates the evaluation
+	void removePiece(const Square square);
+
+	// Adds or removes a piece of the given type and color on the given square without updating the evaluation (used for undo)
+	void togglePiece(const Piece::Type type, const Piece::Color color, const Square square);
+
+	
+	// Returns true if the given square is attacked by a piece of the given color, false otherwise
+	bool isAttackedBy(const Square square, const Piece::Color attackingColor) const;
 
 
 	// Special case of makeMove for handling castles
@@ -128,77 +168,247 @@ private:
 	void enPassant(const Move move);
 
 
-	// The move stored in the transposition table for the current state of the board
-	Move transpositionTableMove;
+	// Value of the zobrist hash for the current state of the table;
+	uint64_t zobristHash;
 
-	// Function to compare probable move value
-	bool compareMoves(const Move& firstMove, const Move& secondMove) const;
+	// Zobrist hash of only the pawns (used to find the pawn structure in the pawn hash table)
+	uint64_t pawnHash;
 
-	// Checks if a move is valid or not
-	bool isValid(const Move move, const Piece::Color playerToMove);
+	// Pass the turn to the other player and update the hash accordingly
+	void passTheTurn();
 
+	// The default size of the transposition table in megabytes
+	static const int defaultTranspositionTableSize = 64;
 
-	// Value of the zobrist hash for the current state of the table;
-	uint64_t zobristHash;
+	// Transposition table used for storing already searched moves (shared by copies of the board so search threads can use it together)
+	std::shared_ptr<TranspositionTable> transpositionTable;
 
-	// Zobrist hash values for each type of piece of each color on every possible square
-	uint64_t zobristValues[2][7][8][8];
+	// Syzygy endgame tablebases probed by the search (shared by copies of the board so the files are only mapped once)
+	std::shared_ptr<Tablebases> tablebases;
 
-	// Zorbist hash value for the player turn
-	uint64_t blackToMoveZobristValue;
+	// Returns true if the position on the board can be probed in the tablebases (few enough pieces and no castling rights)
+	bool canProbeTablebases() const;
 
-	// Pass the turn to the other player and update the hash accordingly
-	void passTheTurn();
+	// Change the current hash of the board (and the pawn hash for pawns) according to adding or removing the given piece on the given square
+	void applyChangeToZobristHash(const Piece piece, const Square square);
+
+
+	// Material and positional value of the pieces with the middle game and with the end game tables (positive values favour white)
+	int middlegameEvaluation;
+	int endgameEvaluation;
+
+	// Phase weight of the pieces left on the board, from 0 when only kings and pawns are left up to maxGamePhase with all the pieces of the starting position
+	int gamePhase;
+
+	// The game phase of the starting position (higher phases are treated as the starting one)
+	static const int maxGamePhase = 24;
+
+	// Add the value of a piece on the given square to the evaluations and its weight to the game phase (sign 1), or remove them (sign -1)
+	void updateEvaluation(const Piece piece, const Square square, const int sign);
+
+	// Pawn structure evaluations already computed by this board (pawn structures repeat a lot within a search)
+	mutable PawnHashTable pawnTable;
+
+	// Compute the middle game and end game values of the doubled, isolated, backward and passed pawns (positive values favour white)
+	void evaluatePawnStructure(int& middlegameValue, int& endgameValue) const;
+
+	// Neural network that replaces the tables in evaluate() once a network file is loaded (shared by copies of the board so the file is only mapped once)
+	std::shared_ptr<Nnue> network;
 
-	// The size of the transposition table
-	int transpositionTableSize = 16777213;
+	// Hidden layer of the network for the position after every move of the undo history (index historySize is the current position, empty without a network)
+	std::vector<Nnue::Accumulator> accumulators;
 
-	// Get an index that fits in the transposition table
-	int getZobristHash() const;
+	// Stop signal, node count and limits of the current search (shared by copies of the board so every search thread is stopped at once)
+	std::shared_ptr<SearchController> searchController;
 
-	// Transposition table used for storing already searched moves
-	std::vector<TranspositionTableEntry> transpositionTable;
+	// Decides when the current search should stop (only used by the main search thread)
+	TimeManager timeManager;
 
-	// Change the current hash of the board according to adding or removing the given piece
-	void applyChangeToZobristHash(const Piece piece);
+	// True once this board has seen that the search was stopped (only refreshed every few nodes so the shared flag is not read at every node)
+	bool searchStopped;
 
+	// The number of nodes searched by this board that have not been added to the shared node count yet
+	uint64_t pendingNodes;
 
-	// Value used for board evaluation
-	int evaluation;
+	// The number of nodes a board searches between two updates of the shared node count and the stop flag
+	static const int nodeCountInterval = 1024;
 
-	// Number of seconds available for searching the best move
-	static const int searchTime = 10;
+	// Count a searched node, adding the nodes to the shared node count and checking if the search was stopped every few nodes
+	void countNode();
 
-	// Bool value to notify the search time has been exceeded
-	std::atomic<bool> stopSearch{ false };
+	// The number of threads that search for the best move
+	int threadCount;
 	
-	// The move found by the minimax algorithm using the previous depth (used for iterative deepening)
+	// The move found by the search using the previous depth (used for iterative deepening)
 	Move bestMoveForPreviousDepth;
 
 	// The maximum depth of the move search
 	static const int maxSearchDepth = 100;
 
-	// Minimax algorithm that searches for the best possible move
-	minimaxResult minimax(int depth, int alpha, int beta, const bool whiteToMove);
+	// Room in the undo history kept free for a search after the moves of the game (the deepest line of the search and the moves tried at the end of it)
+	static const int searchHistoryReserve = maxSearchDepth + 64;
+
+	// The value of a checkmate on the board (a mate found n moves from the root of the search is worth mateValue - n for the winning player)
+	static const int mateValue = 30000;
+
+	// Scores at least this big are mate scores
+	static const int mateThreshold = mateValue - maxSearchDepth;
+
+	// The value of a position the tablebases know is won (below the mate scores so a real mate is still preferred)
+	static const int tablebaseWinValue = mateThreshold - maxSearchDepth - 1;
+
+	// A value bigger than any evaluation (used for the initial search window)
+	static const int infinityValue = 32000;
+
+	// Half width of the aspiration window around the score of the previous depth
+	static const int aspirationWindow = 25;
+
+	// Minimum depth for null move pruning and late move reductions
+	static const int nullMoveMinimumDepth = 3;
+	static const int reductionMinimumDepth = 3;
+
+	// Maximum depth for reverse futility pruning and futility pruning, and the margins per depth they use
+	static const int reverseFutilityMaximumDepth = 6;
+	static const int reverseFutilityMargin = 80;
+	static const int futilityMaximumDepth = 2;
+	static const int futilityMargin = 120;
+
+	// Maximum depth for skipping losing captures and the material per depth a capture has to lose to be skipped there
+	static const int staticExchangeMaximumDepth = 3;
+	static const int staticExchangeMargin = 100;
+
+	// Extra value a capture has to be able to win for the quiescence search to try it when the player is behind alpha
+	static const int deltaMargin = 200;
+
+	// The size of the undo history when the search started (the distance from the root of the search is historySize - rootHistorySize)
+	int rootHistorySize;
+
+	// Two quiet moves for each distance from the root that recently caused a beta cutoff
+	Move killerMoves[maxSearchDepth + 1][2];
+
+	// Score for each quiet move of each color (indexed by initial and target square) that grows every time the move causes a beta cutoff
+	int historyTable[2][64][64];
+
+	// Remember a quiet move that caused a beta cutoff at the given depth for move ordering
+	void storeCutoffMove(const Move move, const Piece::Color color, const int depth);
+
+	// The selective search techniques that are used
+	SearchOptions searchOptions;
+
+	// Pass the turn without moving a piece (used by null move pruning), returns false and leaves the board unchanged if the undo history is full
+	bool makeNullMove();
+
+	// Undo a move made by makeNullMove
+	void undoNullMove();
+
+	// Returns true if the given color has a piece other than pawns and the king (positions without one are often zugzwang)
+	bool hasNonPawnMaterial(const Piece::Color color) const;
+
+	// Negamax principal variation search for the best move of the player to move, the value is from the point of view of that player
+	minimaxResult negamax(int depth, int alpha, int beta);
+
+	// Search only the captures and promotions until the position is quiet, returns the evaluation from the point of view of the player to move
+	int quiescence(int alpha, int beta);
+
+	// Search with increasing depth starting from the given one until the search is stopped, returns the best move of the last completed depth (the main thread reports every completed depth)
+	Move iterativeDeepening(const int startDepth, const bool mainThread);
 
 public:
+	// FEN of the default chess setup
+	static const char* const startingFen;
+
 	// Construct a board with the default chess setup
 	Board();
 
-	// Returns the piece at the given position
-	Piece getPiece(const Position position) const;
+	// Set up the board from a FEN string (placement, side to move, castling rights, en passant square and move counters), returns false and leaves the board unchanged if the FEN is not valid
+	bool loadFen(const std::string& fen);
+
+	// Compute the FEN string of the current state of the board
+	std::string getFen() const;
 
-	// Gets all pseudo legal moves of the given color
+	// Returns true if the undo history has room for another move of the game and a full search after it
+	bool hasRoomForGameMove() const;
+
+	// Forget the records of the moves made so far to make room in the undo history (the position stays the same but the moves can not be undone anymore)
+	void clearHistory();
+
+	// Get the color of the player whose turn it is
+	Piece::Color getPlayerToMove() const;
+
+	// Returns the piece on the given square
+	Piece getPiece(const Square square) const;
+
+	// Get the squares of the pieces of the given type and color
+	Bitboard getPieces(const Piece::Type type, const Piece::Color color) const;
+
+	// Get the square a pawn can capture en passant on (-1 if the last move was not a pawn moving two squares)
+	int getEnPassantSquare() const;
+
+	// Get the number of pieces on the board (kings included)
+	int getPieceCount() const;
+
+	// Get the number of half moves since the last capture or pawn move
+	int getHalfmoveClock() const;
+
+	// Get the castling rights of both players as bits (1 white kingside, 2 white queenside, 4 black kingside, 8 black queenside),
+	// a right is lost once the king or the rook of that side moves or the rook is captured
+	int castlingRights() const;
+
+	// Gets all legal moves of the given color
 	std::vector<Move> getMoves(const Piece::Color playerColor) const;
 
-	// Compute an evaluation of the current state of the board (positive values favour white and negative values favour black)
+	// Fills the given move list with all legal moves of the given color (an empty list means checkmate or stalemate)
+	void getMoves(const Piece::Color playerColor, MoveList& moves) const;
+
+	// Fills the given move list with the legal captures and promotions of the given color
+	void getCaptures(const Piece::Color playerColor, MoveList& moves) const;
+
+	// Returns true if the king of given color is in check, false otherwise
+	bool isInCheck(const Piece::Color color) const;
+
+	// Returns true if the given move does not capture anything and is not a promotion, false otherwise
+	bool isQuietMove(const Move move) const;
+
+	// Returns true if the given legal move puts the king of the other player in check (found from the attack tables without making the move)
+	bool givesCheck(const Move move) const;
+
+	// Compute the material the player making the given capture wins once both players have captured on its target square for as long as it pays off,
+	// each player always captures with its least valuable piece and the sliders behind a piece that captured join in (the move is not made)
+	int staticExchangeEvaluation(const Move move) const;
+
+	// Compute an evaluation of the current state of the board (positive values favour white and negative values favour black),
+	// the middle game and end game evaluations (with the pawn structure) are blended by the game phase so the king walks to the center once the pieces are traded (the network evaluates instead if one is loaded)
 	int evaluate() const;
 
-	// Search and retrieve the best possible move for the given color considering the current state of the board
-	Move getBestMove(const Piece::Color playerToMove);
+	// Search and retrieve the best possible move for the player to move within the given limits
+	Move getBestMove(const SearchLimits& limits);
+
+	// Clear the stop signal before a search (must be called before getBestMove by the thread that can stop the search, so a stop sent right after it is kept)
+	void prepareSearch();
+
+	// Stop the current search as soon as possible (can be called from another thread)
+	void stopSearching();
+
+	// Set the size of the transposition table in megabytes (the table is cleared), returns false if the memory can not be allocated and the table keeps its previous size
+	bool setTranspositionTableSize(const int megabytes);
+
+	// Get the selective search techniques that are used
+	SearchOptions getSearchOptions() const;
+
+	// Set the selective search techniques that are used
+	void setSearchOptions(const SearchOptions& options);
 
-	// Makes the given move on the board
-	void makeMove(const Move move);
+	// Look for Syzygy tablebase files in the given directories (separated by ';' on Windows and ':' elsewhere), returns the number of pieces of the largest table found
+	int setTablebasePath(const std::string& paths);
+
+	// Evaluate with the neural network in the given file (empty or "<empty>" to go back to the tables), returns false and uses the tables if the file can not be loaded
+	bool setEvalFile(const std::string& path);
+
+	// Set the number of threads used by getBestMove (helper threads search their own copy of the board and share the transposition table)
+	void setThreadCount(const int newThreadCount);
+
+	// Makes the given move on the board, returns false and leaves the board unchanged if the undo history is full
+	bool makeMove(const Move move);
 
 	// Undoes the last move that was made
 	void undoMove();
@@ -221,102 +431,127 @@ const int pieceValue[7] =
 	20000   // King
 };
 
-// Table describing positional value of each piece type
-const int positionValue[8][8][8] =
+// Weight of each piece type in the game phase (the phase falls from 24 to 0 as the pieces other than pawns are traded)
+const int gamePhaseWeight[7] =
+{
+	0,	// Empty square
+	0,	// Pawn
+	1,	// Bishop
+	1,	// Knight
+	2,	// Rook
+	4,	// Queen
+	0	// King
+};
+
+// Middle game and end game penalties of a pawn with a pawn of the same color in front of it, of a pawn without pawns of the same color on the columns next to it,
+// and of a pawn that the pawns next to it can no longer defend and that can not advance without being captured by a pawn
+const int doubledPawnPenalty[2] = { 10, 20 };
+const int isolatedPawnPenalty[2] = { 10, 15 };
+const int backwardPawnPenalty[2] = { 8, 10 };
+
+// Middle game and end game bonus of a pawn that no pawn of the other color can stop, for each row counted from its own side (index 0 is the first rank)
+const int passedPawnBonus[2][8] =
+{
+	{ 0, 5, 10, 15, 25, 45, 70, 0 },
+	{ 0, 10, 15, 25, 45, 75, 120, 0 }
+};
+
+// Table describing positional value of each piece type on each square from the point of view of white (the king has a middle game table at index 6 and an end game table at index 7)
+const int positionValue[8][64] =
 {
 	// Empty square value table (index 0)
 	{
-		{  0,   0,   0,   0,   0,   0,   0,   0 },
-		{  0,   0,   0,   0,   0,   0,   0,   0 },
-		{  0,   0,   0,   0,   0,   0,   0,   0 },
-		{  0,   0,   0,   0,   0,   0,   0,   0 },
-		{  0,   0,   0,   0,   0,   0,   0,   0 },
-		{  0,   0,   0,   0,   0,   0,   0,   0 },
-		{  0,   0,   0,   0,   0,   0,   0,   0 },
-		{  0,   0,   0,   0,   0,   0,   0,   0 }
+		 0,   0,   0,   0,   0,   0,   0,   0,
+		 0,   0,   0,   0,   0,   0,   0,   0,
+		 0,   0,   0,   0,   0,   0,   0,   0,
+		 0,   0,   0,   0,   0,   0,   0,   0,
+		 0,   0,   0,   0,   0,   0,   0,   0,
+		 0,   0,   0,   0,   0,   0,   0,   0,
+		 0,   0,   0,   0,   0,   0,   0,   0,
+		 0,   0,   0,   0,   0,   0,   0,   0
 	},
 
 	// Pawn value table (index 1)
 	{
-		{  0,   0,   0,   0,   0,   0,   0,   0 },
-		{ 50,  50,  50,  50,  50,  50,  50,  50 },
-		{ 10,  10,  20,  30,  30,  20,  10,  10 },
-		{  5,   5,  10,  25,  25,  10,   5,   5 },
-		{  0,   0,   0,  20,  20,   0,   0,   0 },
-		{  5,  -5, -10,   0,   0, -10,  -5,   5 },
-		{  5,  10,  10, -20, -20,  10,  10,   5 },
-		{  0,   0,   0,   0,   0,   0,   0,   0 }
+		 0,   0,   0,   0,   0,   0,   0,   0,
+		50,  50,  50,  50,  50,  50,  50,  50,
+		10,  10,  20,  30,  30,  20,  10,  10,
+		 5,   5,  10,  25,  25,  10,   5,   5,
+		 0,   0,   0,  20,  20,   0,   0,   0,
+		 5,  -5, -10,   0,   0, -10,  -5,   5,
+		 5,  10,  10, -20, -20,  10,  10,   5,
+		 0,   0,   0,   0,   0,   0,   0,   0
 	},
 
 	// Bishop value table (index 2)
 	{
-		{-20, -10, -10, -10, -10, -10, -10, -20 },
-		{-10,   0,   0,   0,   0,   0,   0, -10 },
-		{-10,   0,   5,  10,  10,   5,   0, -10 },
-		{-10,   5,   5,  10,  10,   5,   5, -10 },
-		{-10,   0,  10,  10,  10,  10,   0, -10 },
-		{-10,  10,  10,  10,  10,  10,  10, -10 },
-		{-10,   5,   0,   0,   0,   0,   5, -10 },
-		{-20, -10, -10, -10, -10, -10, -10, -20 }
+		-20, -10, -10, -10, -10, -10, -10, -20,
+		-10,   0,   0,   0,   0,   0,   0, -10,
+		-10,   0,   5,  10,  10,   5,   0, -10,
+		-10,   5,   5,  10,  10,   5,   5, -10,
+		-10,   0,  10,  10,  10,  10,   0, -10,
+		-10,  10,  10,  10,  10,  10,  10, -10,
+		-10,   5,   0,   0,   0,   0,   5, -10,
+		-20, -10, -10, -10, -10, -10, -10, -20
 	},
 
 	// Knight value table (index 3)
 	{
-		{-50, -40, -30, -30, -30, -30, -40, -50 },
-		{-40, -20,   0,   5,   5,   0, -20, -40 },
-		{-30,   5,  10,  15,  15,  10,   5, -30 },
-		{-30,   0,  15,  20,  20,  15,   0, -30 },
-		{-30,   5,  15,  20,  20,  15,   5, -30 },
-		{-30,   0,  10,  15,  15,  10,   0, -30 },
-		{-40, -20,   0,   0,   0,   0, -20, -40 },
-		{-50, -40, -30, -30, -30, -30, -40, -50 }
+		-50, -40, -30, -30, -30, -30, -40, -50,
+		-40, -20,   0,   5,   5,   0, -20, -40,
+		-30,   5,  10,  15,  15,  10,   5, -30,
+		-30,   0,  15,  20,  20,  15,   0, -30,
+		-30,   5,  15,  20,  20,  15,   5, -30,
+		-30,   0,  10,  15,  15,  10,   0, -30,
+		-40, -20,   0,   0,   0,   0, -20, -40,
+		-50, -40, -30, -30, -30, -30, -40, -50
 	},
 
 	// Rook value table (index 4)
 	{
-		{  0,   0,   0,   0,   0,   0,   0,   0 },
-		{  5,  10,  10,  10,  10,  10,  10,   5 },
-		{ -5,   0,   0,   0,   0,   0,   0,  -5 },
-		{ -5,   0,   0,   0,   0,   0,   0,  -5 },
-		{ -5,   0,   0,   0,   0,   0,   0,  -5 },
-		{ -5,   0,   0,   0,   0,   0,   0,  -5 },
-		{ -5,   0,   0,   0,   0,   0,   0,  -5 },
-		{  0,   0,   0,   5,   5,   0,   0,   0 }
+		 0,   0,   0,   0,   0,   0,   0,   0,
+		 5,  10,  10,  10,  10,  10,  10,   5,
+		-5,   0,   0,   0,   0,   0,   0,  -5,
+		-5,   0,   0,   0,   0,   0,   0,  -5,
+		-5,   0,   0,   0,   0,   0,   0,  -5,
+		-5,   0,   0,   0,   0,   0,   0,  -5,
+		-5,   0,   0,   0,   0,   0,   0,  -5,
+		 0,   0,   0,   5,   5,   0,   0,   0
 	},
 
 	// Queen value table (index 5)
 	{
-		{-20, -10, -10,  -5,  -5, -10, -10, -20 },
-		{-10,   0,   5,   0,   0,   0,   0, -10 },
-		{-10,   0,   5,   5,   5,   5,   0, -10 },
-		{ -5,   0,   5,   5,   5,   5,   0,  -5 },
-		{  0,   0,   5,   5,   5,   5,   0,  -5 },
-		{-10,   0,   5,   5,   5,   5,   0, -10 },
-		{-10,   0,   0,   0,   0,   0,   0, -10 },
-		{-20, -10, -10,  -5,  -5, -10, -10, -20 }
+		-20, -10, -10,  -5,  -5, -10, -10, -20,
+		-10,   0,   5,   0,   0,   0,   0, -10,
+		-10,   0,   5,   5,   5,   5,   0, -10,
+		-5,   0,   5,   5,   5,   5,   0,  -5,
+		 0,   0,   5,   5,   5,   5,   0,  -5,
+		-10,   0,   5,   5,   5,   5,   0, -10,
+		-10,   0,   0,   0,   0,   0,   0, -10,
+		-20, -10, -10,  -5,  -5, -10, -10, -20
 	},
 
 	// King early and mid game value table
 	{
-		{ -30, -40, -40, -50, -50, -40, -40, -30 },
-		{ -30, -40, -40, -50, -50, -40, -40, -30 },
-		{ -30, -40, -40, -50, -50, -40, -40, -30 },
-		{ -30, -40, -40, -50, -50, -40, -40, -30 },
-		{ -20, -30, -30, -40, -40, -30, -30, -20 },
-		{ -10, -20, -20, -20, -20, -20, -20, -10 },
-		{  20,  30,  10,   0,   0,  10,  30,  20 },
-		{  20,  20,   0,   0,   0,   0,  20,  20 }
+		-30, -40, -40, -50, -50, -40, -40, -30,
+		-30, -40, -40, -50, -50, -40, -40, -30,
+		-30, -40, -40, -50, -50, -40, -40, -30,
+		-30, -40, -40, -50, -50, -40, -40, -30,
+		-20, -30, -30, -40, -40, -30, -30, -20,
+		-10, -20, -20, -20, -20, -20, -20, -10,
+		 20,  30,  10,   0,   0,  10,  30,  20,
+		 20,  20,   0,   0,   0,   0,  20,  20
 	},
 
 	// King end game value table
 	{
-		{ -50, -30, -30, -30, -30, -30, -30, -50 },
-		{ -30, -30,   0,   0,   0,   0, -30, -30 },
-		{ -30, -10,  20,  30,  30,  20, -10, -30 },
-		{ -30, -10,  30,  40,  40,  30, -10, -30 },
-		{ -30, -10,  30,  40,  40,  30, -10, -30 },
-		{ -30, -10,  20,  30,  30,  20, -10, -30 },
-		{ -30, -20, -10,   0,   0, -10, -20, -30 },
-		{ -50, -40, -30, -20, -20, -30, -40, -50 }
+		-50, -30, -30, -30, -30, -30, -30, -50,
+		-30, -30,   0,   0,   0,   0, -30, -30,
+		-30, -10,  20,  30,  30,  20, -10, -30,
+		-30, -10,  30,  40,  40,  30, -10, -30,
+		-30, -10,  30,  40,  40,  30, -10, -30,
+		-30, -10,  20,  30,  30,  20, -10, -30,
+		-30, -20, -10,   0,   0, -10, -20, -30,
+		-50, -40, -30, -20, -20, -30, -40, -50
 	}
 };
\ No newline at end of file
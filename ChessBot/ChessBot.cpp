@@ -1,94 +1,52 @@
 #include <iostream>
 #include "Board.h"
-#include <chrono>
+#include "OpeningBook.h"
+#include "Perft.h"
+#include "Tablebases.h"
+#include "Uci.h"
+#include <cstdlib>
+#include <cstring>
+#include <memory>
 
 
-int main()
+int main(int argc, char* argv[])
 {
-    Board board;
-
-    Piece::Color playerToMove = Piece::Color::WHITE;
-    while (true)
+    // "perft" runs the reference suite and "perft <depth> [fen]" counts the moves of a position (the initial one by default) with a per move breakdown
+    if (argc > 1 && std::strcmp(argv[1], "perft") == 0)
     {
-        std::cout << "Evaluation: " << board.evaluate() << "\n";
-        std::cout << board.toString() << "\n\n";
-
-        std::cout << "Attacked by white: " << "\n";
-        std::cout << board.attackedSquaresToString(Piece::Color::WHITE) << "\n\n";
-
-        std::cout << "Attacked by black: " << "\n";
-        std::cout << board.attackedSquaresToString(Piece::Color::BLACK) << "\n\n";
-
-        std::vector<Move> moves = board.getMoves(playerToMove);
-        for (auto move : moves)
-            std::cout << move.toString() << "\n";
-
-        if (playerToMove == Piece::Color::WHITE)
+        if (argc > 2)
         {
-            std::cout << "Enter move for white: ";
-
-            int initialRow, initialColumn;
-            int targetRow, targetColumn;
-
-            std::cin >> initialRow >> initialColumn >> targetRow >> targetColumn;
+            std::unique_ptr<Board> perftBoard(new Board());
 
-            Move move = Move(Position(initialRow, initialColumn), Position(targetRow, targetColumn));
+            // The FEN is made of several arguments
+            std::string fen;
+            for (int i = 3; i < argc; i++)
+                fen += std::string(argv[i]) + " ";
 
-            if (targetRow == 0 && board.getPiece(Position(targetRow, targetColumn)).getType() == Piece::Type::PAWN)
+            if (!fen.empty() && !perftBoard->loadFen(fen))
             {
-                std::cout << "Promote pawn to (Q, R, B, K): ";
-                char promotionType;
-                std::cin >> promotionType;
-                switch (promotionType)
-                {
-                case 'Q':
-                    move.setPromotionType(Piece::Type::QUEEN);
-                    break;
-                case 'q':
-                    move.setPromotionType(Piece::Type::QUEEN);
-                    break;
-                case 'R':
-                    move.setPromotionType(Piece::Type::ROOK);
-                    break;
-                case 'r':
-                    move.setPromotionType(Piece::Type::ROOK);
-                    break;
-                case 'B':
-                    move.setPromotionType(Piece::Type::BISHOP);
-                    break;
-                case 'b':
-                    move.setPromotionType(Piece::Type::BISHOP);
-                    break;
-                case 'K':
-                    move.setPromotionType(Piece::Type::KNIGHT);
-                    break;
-                case 'k':
-                    move.setPromotionType(Piece::Type::KNIGHT);
-                    break;
-                default:
-                    move.setPromotionType(Piece::Type::QUEEN);
-                }
+                std::cout << "Invalid FEN: " << fen << "\n";
+                return 1;
             }
 
-            board.makeMove(move);
-
-            playerToMove = Piece::Color::BLACK;
+            Perft(*perftBoard).divide(std::atoi(argv[2]), std::cout);
+            return 0;
         }
-        else
-        {
-            Move move = board.getBestMove(playerToMove);
 
-            board.makeMove(move);
-            std::cout << "Black moved: " << move.toString() << "\n";
-
-            playerToMove = Piece::Color::WHITE;
-        }
+        return Perft::runSuite(std::cout) ? 0 : 1;
+    }
 
-        std::cout << "\n";
+    // "test" checks the Polyglot keys against the reference values and the fallback to the search without tablebases
+    if (argc > 1 && std::strcmp(argv[1], "test") == 0)
+    {
+        bool passed = OpeningBook::runKeySuite(std::cout);
+        passed = Tablebases::runFallbackSuite(std::cout) && passed;
+        return passed ? 0 : 1;
     }
 
-    if (playerToMove == Piece::Color::WHITE)
-        playerToMove = Piece::Color::BLACK;
-    else
-        playerToMove = Piece::Color::WHITE;
-}
\ No newline at end of file
+    // Otherwise the engine talks to a graphical interface or a tournament manager through UCI
+    Uci uci;
+    uci.loop();
+
+    return 0;
+}
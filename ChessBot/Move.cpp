@@ -1,40 +1,66 @@
 #include "Move.h"
 
-Move::Move() : initialPosition(Position()), targetPosition(Position()), promotionType(Piece::Type::NONE) {}
+Move::Move(const Square initialSquare, const Square targetSquare, const Piece::Type promotionType) : data((uint16_t)(initialSquare | (targetSquare << 6)))
+{
+	this->setPromotionType(promotionType);
+}
+
+Move::Move(const Square initialSquare, const Square targetSquare, const Flag flag) : data((uint16_t)(initialSquare | (targetSquare << 6) | (flag << 14))) {}
+
+Move::Move(const uint16_t data) : data(data) {}
 
-Move::Move(const Position initialPosition, const Position targetPosition, const Piece::Type promotionType) : initialPosition(initialPosition), targetPosition(targetPosition), promotionType(promotionType) {}
+Square Move::getInitialSquare() const
+{
+	return this->data & 0x3F;
+}
+
+Square Move::getTargetSquare() const
+{
+	return (this->data >> 6) & 0x3F;
+}
 
-Position Move::getInitialPosition() const
+Move::Flag Move::getFlag() const
 {
-	return this->initialPosition;
+	return (Move::Flag)(this->data >> 14);
 }
 
-Position Move::getTargetPosition() const
+uint16_t Move::getData() const
 {
-	return this->targetPosition;
+	return this->data;
 }
 
 Piece::Type Move::getPromotionType() const
 {
-	return this->promotionType;
+	if (this->getFlag() != Move::Flag::PROMOTION)
+		return Piece::Type::NONE;
+
+	// The promotion types (bishop, knight, rook and queen) are stored as 0 to 3
+	return (Piece::Type)(((this->data >> 12) & 0x3) + Piece::Type::BISHOP);
 }
 
 void Move::setPromotionType(const Piece::Type newPromotionType)
 {
-	this->promotionType = newPromotionType;
+	// Keep only the squares
+	this->data &= 0xFFF;
+
+	if (newPromotionType != Piece::Type::NONE)
+		this->data |= (uint16_t)(((newPromotionType - Piece::Type::BISHOP) << 12) | (Move::Flag::PROMOTION << 14));
 }
 
 bool Move::operator==(const Move& other) const
 {
-	return this->initialPosition == other.initialPosition && this->targetPosition == other.targetPosition && this->promotionType == other.promotionType;
+	return this->data == other.data;
 }
 
 std::string Move::toString() const
 {
-	std::string moveString = "(" + std::to_string(this->initialPosition.row()) + ", " + std::to_string(this->initialPosition.column()) + ") -> " +
-		"(" + std::to_string(this->targetPosition.row()) + ", " + std::to_string(this->targetPosition.column()) + ")";
+	Square initialSquare = this->getInitialSquare();
+	Square targetSquare = this->getTargetSquare();
+
+	std::string moveString = "(" + std::to_string(squareRow(initialSquare)) + ", " + std::to_string(squareColumn(initialSquare)) + ") -> " +
+		"(" + std::to_string(squareRow(targetSquare)) + ", " + std::to_string(squareColumn(targetSquare)) + ")";
 	
-	switch (this->promotionType)
+	switch (this->getPromotionType())
 	{
 	case Piece::QUEEN:
 		moveString += " Promote to Queen";
@@ -54,3 +80,36 @@ std::string Move::toString() const
 	
 	return moveString;
 }
+
+std::string Move::toAlgebraicString() const
+{
+	Square initialSquare = this->getInitialSquare();
+	Square targetSquare = this->getTargetSquare();
+
+	// Row 0 is the eighth rank and column 0 is the a file
+	std::string moveString;
+	moveString += (char)('a' + squareColumn(initialSquare));
+	moveString += (char)('8' - squareRow(initialSquare));
+	moveString += (char)('a' + squareColumn(targetSquare));
+	moveString += (char)('8' - squareRow(targetSquare));
+
+	switch (this->getPromotionType())
+	{
+	case Piece::QUEEN:
+		moveString += 'q';
+		break;
+	case Piece::ROOK:
+		moveString += 'r';
+		break;
+	case Piece::BISHOP:
+		moveString += 'b';
+		break;
+	case Piece::KNIGHT:
+		moveString += 'n';
+		break;
+	default:
+		break;
+	}
+
+	return moveString;
+}
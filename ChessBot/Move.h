@@ -1,37 +1,60 @@
 #pragma once
 #include <utility>
 #include <string>
-#include "Position.h"
+#include <cstdint>
+#include "Square.h"
 #include "Piece.h"
 
 
 class Move
 {
+public:
+	// Enum of the special kinds of moves
+	enum Flag
+	{
+		NORMAL = 0,
+		PROMOTION = 1,
+		EN_PASSANT = 2,
+		CASTLING = 3
+	};
+
 private:
-	Position initialPosition;
-	Position targetPosition;
-	Piece::Type promotionType;
+	// Packed move: bits 0-5 hold the initial square, bits 6-11 the target square, bits 12-13 the promotion type and bits 14-15 the flag
+	uint16_t data;
 
 public:
-	// Construct an empty move
-	Move();
-	// Construct a move given an initial position, a target position and a promotion type in case of pawn promotion
-	Move(const Position initialPosition, const Position targetPosition, const Piece::Type promotionType = Piece::Type::NONE);
+	// Construct an empty move (left uninitialized when default initialized so move lists can be created without any cost, Move() is still the empty move)
+	Move() = default;
+	// Construct a move given an initial square, a target square and a promotion type in case of pawn promotion
+	Move(const Square initialSquare, const Square targetSquare, const Piece::Type promotionType = Piece::Type::NONE);
+	// Construct a move given an initial square, a target square and the kind of move
+	Move(const Square initialSquare, const Square targetSquare, const Flag flag);
+	// Construct a move from its packed 16 bit representation
+	explicit Move(const uint16_t data);
 	
-	// Get the position from which the piece moves
-	Position getInitialPosition() const;
-	// Get the position the piece is moving to
-	Position getTargetPosition() const;
+	// Get the index of the square from which the piece moves
+	Square getInitialSquare() const;
+	// Get the index of the square the piece is moving to
+	Square getTargetSquare() const;
+
+	// Get the kind of the move
+	Flag getFlag() const;
+
+	// Get the packed 16 bit representation of the move
+	uint16_t getData() const;
 	
 	// Get the type of piece the pawn is promoting to
 	Piece::Type getPromotionType() const;
 	// Set the type of piece the pawn is promoting to
 	void setPromotionType(const Piece::Type newPromotionType);
 
-	// Returns true if positions and promotion type are the same, false otherwise
+	// Returns true if the squares, the kind and the promotion type are the same, false otherwise
 	bool operator ==(const Move& other) const;
 
 	// Compute a string to describe the current move
 	std::string toString() const;
+
+	// Compute the long algebraic notation of the move (for example "e2e4" or "e7e8q")
+	std::string toAlgebraicString() const;
 };
 
@@ -0,0 +1,58 @@
+#include "MoveList.h"
+
+MoveList::MoveList() : count(0) {}
+
+void MoveList::push(const Move move)
+{
+	this->moves[this->count++] = move;
+}
+
+void MoveList::clear()
+{
+	this->count = 0;
+}
+
+void MoveList::truncate(const int newCount)
+{
+	this->count = newCount;
+}
+
+int MoveList::size() const
+{
+	return this->count;
+}
+
+bool MoveList::empty() const
+{
+	return this->count == 0;
+}
+
+Move& MoveList::operator[](const int index)
+{
+	return this->moves[index];
+}
+
+const Move& MoveList::operator[](const int index) const
+{
+	return this->moves[index];
+}
+
+Move* MoveList::begin()
+{
+	return this->moves;
+}
+
+Move* MoveList::end()
+{
+	return this->moves + this->count;
+}
+
+const Move* MoveList::begin() const
+{
+	return this->moves;
+}
+
+const Move* MoveList::end() const
+{
+	return this->moves + this->count;
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include "Move.h"
+
+// Fixed capacity list of moves that lives on the stack (no position has more than 218 moves)
+class MoveList
+{
+public:
+	// The maximum number of moves the list can hold
+	static const int capacity = 256;
+
+	// Construct an empty move list
+	MoveList();
+
+	// Add a move at the end of the list
+	void push(const Move move);
+
+	// Remove all moves from the list
+	void clear();
+
+	// Keep only the first given number of moves
+	void truncate(const int newCount);
+
+	// Get the number of moves in the list
+	int size() const;
+
+	// Check if the list holds no moves
+	bool empty() const;
+
+	// Get the move at the given index
+	Move& operator [](const int index);
+	const Move& operator [](const int index) const;
+
+	// Iterators over the moves of the list
+	Move* begin();
+	Move* end();
+	const Move* begin() const;
+	const Move* end() const;
+
+private:
+	Move moves[capacity];
+	int count;
+};
@@ -0,0 +1,135 @@
+#include "MovePicker.h"
+#include "Board.h"
+#include <utility>
+
+MovePicker::MovePicker(const Board& board, MoveList& moves, const Move hashMove, const Move killers[2], const int history[64][64]) :
+	board(board), moves(moves), hashMove(hashMove), killers(killers), history(history), stage(Stage::HASH_MOVE), current(0), goodCapturesEnd(0), capturesEnd(0), end(moves.size()), killerIndex(0) {}
+
+Move MovePicker::pickBest(const int last)
+{
+	int best = this->current;
+	for (int i = this->current + 1; i < last; i++)
+		if (this->scores[i] > this->scores[best])
+			best = i;
+
+	std::swap(this->moves[this->current], this->moves[best]);
+	std::swap(this->scores[this->current], this->scores[best]);
+
+	return this->moves[this->current++];
+}
+
+bool MovePicker::next(Move& move)
+{
+	if (this->stage == Stage::HASH_MOVE)
+	{
+		this->stage = Stage::SCORE_CAPTURES;
+
+		// Hand out the hash move if it is one of the moves of the position, taking it out of the list so it is not handed out again
+		for (int i = 0; i < this->end; i++)
+			if (this->moves[i] == this->hashMove)
+			{
+				std::swap(this->moves[i], this->moves[--this->end]);
+				move = this->hashMove;
+				return true;
+			}
+	}
+
+	if (this->stage == Stage::SCORE_CAPTURES)
+	{
+		// Move the captures and promotions to the front of the list and score them by MVV-LVA (most valuable victim, least valuable attacker)
+		for (int i = 0; i < this->end; i++)
+			if (!this->board.isQuietMove(this->moves[i]))
+			{
+				Move capture = this->moves[i];
+				int victimValue = capture.getFlag() == Move::Flag::EN_PASSANT ? pieceValue[Piece::Type::PAWN] : pieceValue[this->board.getPiece(capture.getTargetSquare()).getType()];
+				int attackerValue = pieceValue[this->board.getPiece(capture.getInitialSquare()).getType()];
+
+				// A promotion gains the value of the new piece
+				victimValue += pieceValue[capture.getPromotionType()];
+
+				std::swap(this->moves[i], this->moves[this->capturesEnd]);
+				this->scores[this->capturesEnd] = victimValue * 64 - attackerValue;
+
+				// Only a capture with a more valuable attacker than its victim can lose material, those that do are kept behind the others
+				if (victimValue >= attackerValue || this->board.staticExchangeEvaluation(capture) >= 0)
+				{
+					std::swap(this->moves[this->capturesEnd], this->moves[this->goodCapturesEnd]);
+					std::swap(this->scores[this->capturesEnd], this->scores[this->goodCapturesEnd]);
+					this->goodCapturesEnd++;
+				}
+				this->capturesEnd++;
+			}
+
+		this->stage = Stage::GOOD_CAPTURES;
+	}
+
+	if (this->stage == Stage::GOOD_CAPTURES)
+	{
+		if (this->current < this->goodCapturesEnd)
+		{
+			move = this->pickBest(this->goodCapturesEnd);
+			return true;
+		}
+
+		// The losing captures wait until the quiet moves have been handed out
+		this->current = this->capturesEnd;
+		this->stage = Stage::KILLERS;
+	}
+
+	if (this->stage == Stage::KILLERS)
+	{
+		// Hand out the killer moves that are quiet moves of this position
+		while (this->killerIndex < 2)
+		{
+			Move killer = this->killers[this->killerIndex++];
+			for (int i = this->current; i < this->end; i++)
+				if (this->moves[i] == killer)
+				{
+					std::swap(this->moves[i], this->moves[this->current]);
+					move = this->moves[this->current++];
+					return true;
+				}
+		}
+
+		this->stage = Stage::SCORE_QUIETS;
+	}
+
+	if (this->stage == Stage::SCORE_QUIETS)
+	{
+		// Score the remaining quiet moves by how often they caused cutoffs before
+		for (int i = this->current; i < this->end; i++)
+			this->scores[i] = this->history[this->moves[i].getInitialSquare()][this->moves[i].getTargetSquare()];
+
+		this->stage = Stage::QUIETS;
+	}
+
+	if (this->stage == Stage::QUIETS)
+	{
+		if (this->current < this->end)
+		{
+			move = this->pickBest(this->end);
+			return true;
+		}
+
+		this->current = this->goodCapturesEnd;
+		this->stage = Stage::LOSING_CAPTURES;
+	}
+
+	if (this->stage == Stage::LOSING_CAPTURES)
+	{
+		if (this->current < this->capturesEnd)
+		{
+			move = this->pickBest(this->capturesEnd);
+			return true;
+		}
+
+		this->stage = Stage::DONE;
+	}
+
+	return false;
+}
+
+bool MovePicker::handingOutLosingCaptures() const
+{
+	return this->stage == Stage::LOSING_CAPTURES;
+}
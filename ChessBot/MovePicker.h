@@ -0,0 +1,57 @@
+#pragma once
+#include "MoveList.h"
+
+class Board;
+
+// Hands out the moves of a position one at a time in the order they should be searched:
+// the hash move, captures ordered by MVV-LVA, killer moves, quiet moves ordered by their history score and then the captures that lose material by the static exchange evaluation
+class MovePicker
+{
+public:
+	// Construct a move picker that reorders the given legal moves in place as they are picked
+	MovePicker(const Board& board, MoveList& moves, const Move hashMove, const Move killers[2], const int history[64][64]);
+
+	// Get the next move to search, returns false when there are no moves left
+	bool next(Move& move);
+
+	// Returns true once the picker hands out the captures that lose material (every move handed out from then on is one of them)
+	bool handingOutLosingCaptures() const;
+
+private:
+	// Enum of the stages the picker goes through
+	enum Stage
+	{
+		HASH_MOVE = 0,
+		SCORE_CAPTURES = 1,
+		GOOD_CAPTURES = 2,
+		KILLERS = 3,
+		SCORE_QUIETS = 4,
+		QUIETS = 5,
+		LOSING_CAPTURES = 6,
+		DONE = 7
+	};
+
+	const Board& board;
+	MoveList& moves;
+	Move hashMove;
+	const Move* killers;
+	const int (*history)[64];
+
+	// Ordering score of each move in the list
+	int scores[MoveList::capacity];
+
+	// The current stage of the picker
+	Stage stage;
+	// Index of the next move to hand out
+	int current;
+	// Index after the last capture that does not lose material and after the last capture (captures are moved to the front of the list, the losing ones behind the others)
+	int goodCapturesEnd;
+	int capturesEnd;
+	// Index after the last move that has not been handed out by the hash move stage
+	int end;
+	// Index of the next killer move to try
+	int killerIndex;
+
+	// Swap the move with the best score in [current, last) to the current index and hand it out
+	Move pickBest(const int last);
+};
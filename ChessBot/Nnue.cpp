@@ -0,0 +1,358 @@
+#include "Nnue.h"
+#include <cstring>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// The vector versions are only built for x86 processors, the processor running the program decides which one is used
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define NNUE_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// GCC and Clang only allow the intrinsics of an instruction set in functions built for it, MSVC allows them everywhere
+#if defined(NNUE_X86) && (defined(__GNUC__) || defined(__clang__))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#else
+#define TARGET_AVX2
+#define TARGET_SSE2
+#endif
+
+// Order of the piece types in the inputs (pawn, knight, bishop, rook, queen, king) for every Piece::Type
+static const int inputType[7] = { 0, 0, 2, 1, 3, 4, 5 };
+
+// Add the weights of an input to the hidden values of one point of view
+static void addWeightsScalar(int16_t* values, const int16_t* weights)
+{
+	for (int i = 0; i < Nnue::hiddenSize; i++)
+		values[i] += weights[i];
+}
+
+// Subtract the weights of an input from the hidden values of one point of view
+static void subtractWeightsScalar(int16_t* values, const int16_t* weights)
+{
+	for (int i = 0; i < Nnue::hiddenSize; i++)
+		values[i] -= weights[i];
+}
+
+// Compute the output of the network before the bias from the hidden values of the player to move and of the other player
+static int32_t outputScalar(const int16_t* ownValues, const int16_t* otherValues, const int8_t* weights)
+{
+	int32_t sum = 0;
+	for (int i = 0; i < Nnue::hiddenSize; i++)
+	{
+		int own = ownValues[i] < 0 ? 0 : ownValues[i] > Nnue::activationScale ? Nnue::activationScale : ownValues[i];
+		int other = otherValues[i] < 0 ? 0 : otherValues[i] > Nnue::activationScale ? Nnue::activationScale : otherValues[i];
+		sum += own * weights[i] + other * weights[Nnue::hiddenSize + i];
+	}
+
+	return sum;
+}
+
+#if defined(NNUE_X86)
+TARGET_AVX2 static void addWeightsAvx2(int16_t* values, const int16_t* weights)
+{
+	for (int i = 0; i < Nnue::hiddenSize; i += 16)
+	{
+		__m256i sum = _mm256_add_epi16(_mm256_loadu_si256((const __m256i*)(values + i)), _mm256_loadu_si256((const __m256i*)(weights + i)));
+		_mm256_storeu_si256((__m256i*)(values + i), sum);
+	}
+}
+
+TARGET_AVX2 static void subtractWeightsAvx2(int16_t* values, const int16_t* weights)
+{
+	for (int i = 0; i < Nnue::hiddenSize; i += 16)
+	{
+		__m256i difference = _mm256_sub_epi16(_mm256_loadu_si256((const __m256i*)(values + i)), _mm256_loadu_si256((const __m256i*)(weights + i)));
+		_mm256_storeu_si256((__m256i*)(values + i), difference);
+	}
+}
+
+// Clip 32 hidden values, pack them into bytes and multiply them with their 8 bit weights, the products are added into the 8 32 bit sums
+TARGET_AVX2 static __m256i addProductsAvx2(__m256i sum, const int16_t* values, const int8_t* weights)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i ceiling = _mm256_set1_epi16(Nnue::activationScale);
+	__m256i low = _mm256_min_epi16(_mm256_max_epi16(_mm256_loadu_si256((const __m256i*)values), zero), ceiling);
+	__m256i high = _mm256_min_epi16(_mm256_max_epi16(_mm256_loadu_si256((const __m256i*)(values + 16)), zero), ceiling);
+
+	// The packing works on each 128 bit half, the permutation puts the 32 bytes back in the order of the weights
+	__m256i activations = _mm256_permute4x64_epi64(_mm256_packus_epi16(low, high), 0xD8);
+	__m256i products = _mm256_maddubs_epi16(activations, _mm256_loadu_si256((const __m256i*)weights));
+	return _mm256_add_epi32(sum, _mm256_madd_epi16(products, _mm256_set1_epi16(1)));
+}
+
+TARGET_AVX2 static int32_t outputAvx2(const int16_t* ownValues, const int16_t* otherValues, const int8_t* weights)
+{
+	__m256i sum = _mm256_setzero_si256();
+
+	for (int i = 0; i < Nnue::hiddenSize; i += 32)
+	{
+		sum = addProductsAvx2(sum, ownValues + i, weights + i);
+		sum = addProductsAvx2(sum, otherValues + i, weights + Nnue::hiddenSize + i);
+	}
+
+	// Add the 8 sums together
+	__m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+	half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0x4E));
+	half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0xB1));
+	return _mm_cvtsi128_si32(half);
+}
+
+TARGET_SSE2 static void addWeightsSse2(int16_t* values, const int16_t* weights)
+{
+	for (int i = 0; i < Nnue::hiddenSize; i += 8)
+	{
+		__m128i sum = _mm_add_epi16(_mm_loadu_si128((const __m128i*)(values + i)), _mm_loadu_si128((const __m128i*)(weights + i)));
+		_mm_storeu_si128((__m128i*)(values + i), sum);
+	}
+}
+
+TARGET_SSE2 static void subtractWeightsSse2(int16_t* values, const int16_t* weights)
+{
+	for (int i = 0; i < Nnue::hiddenSize; i += 8)
+	{
+		__m128i difference = _mm_sub_epi16(_mm_loadu_si128((const __m128i*)(values + i)), _mm_loadu_si128((const __m128i*)(weights + i)));
+		_mm_storeu_si128((__m128i*)(values + i), difference);
+	}
+}
+
+// Load 8 output weights widened to 16 bits (each byte is doubled and shifted back down, which keeps its sign)
+TARGET_SSE2 static __m128i loadWeightsSse2(const int8_t* weights)
+{
+	__m128i bytes = _mm_loadl_epi64((const __m128i*)weights);
+	return _mm_srai_epi16(_mm_unpacklo_epi8(bytes, bytes), 8);
+}
+
+// Clip 8 hidden values at a time and multiply them with their weights, pairs of products are added into 32 bit sums (SSE2 has no byte multiplication)
+TARGET_SSE2 static int32_t outputSse2(const int16_t* ownValues, const int16_t* otherValues, const int8_t* weights)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i ceiling = _mm_set1_epi16(Nnue::activationScale);
+	__m128i sum = _mm_setzero_si128();
+
+	for (int i = 0; i < Nnue::hiddenSize; i += 8)
+	{
+		__m128i own = _mm_min_epi16(_mm_max_epi16(_mm_loadu_si128((const __m128i*)(ownValues + i)), zero), ceiling);
+		__m128i other = _mm_min_epi16(_mm_max_epi16(_mm_loadu_si128((const __m128i*)(otherValues + i)), zero), ceiling);
+		sum = _mm_add_epi32(sum, _mm_madd_epi16(own, loadWeightsSse2(weights + i)));
+		sum = _mm_add_epi32(sum, _mm_madd_epi16(other, loadWeightsSse2(weights + Nnue::hiddenSize + i)));
+	}
+
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+	return _mm_cvtsi128_si32(sum);
+}
+#endif
+
+// The versions of the accumulator and output computations used on this processor
+class Kernels
+{
+public:
+	void (*addWeights)(int16_t*, const int16_t*);
+	void (*subtractWeights)(int16_t*, const int16_t*);
+	int32_t (*output)(const int16_t*, const int16_t*, const int8_t*);
+	const char* name;
+};
+
+// Pick the widest instruction set the processor (and the operating system for the 256 bit registers) supports
+static Kernels selectKernels()
+{
+	bool avx2 = false, sse2 = false;
+
+#if defined(NNUE_X86) && defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	int maxLeaf = info[0];
+	__cpuid(info, 1);
+	sse2 = ((info[3] >> 26) & 1) != 0;
+	bool osSavesAvx = ((info[2] >> 27) & 1) && ((info[2] >> 28) & 1) && (_xgetbv(0) & 6) == 6;
+	if (maxLeaf >= 7)
+	{
+		__cpuidex(info, 7, 0);
+		avx2 = osSavesAvx && ((info[1] >> 5) & 1);
+	}
+#elif defined(NNUE_X86)
+	__builtin_cpu_init();
+	avx2 = __builtin_cpu_supports("avx2") != 0;
+	sse2 = __builtin_cpu_supports("sse2") != 0;
+#endif
+
+#if defined(NNUE_X86)
+	if (avx2)
+		return Kernels{ addWeightsAvx2, subtractWeightsAvx2, outputAvx2, "avx2" };
+	if (sse2)
+		return Kernels{ addWeightsSse2, subtractWeightsSse2, outputSse2, "sse2" };
+#endif
+
+	return Kernels{ addWeightsScalar, subtractWeightsScalar, outputScalar, "scalar" };
+}
+
+static const Kernels kernels = selectKernels();
+
+// Size in bytes of the header of a network file
+static const size_t headerSize = 16;
+
+// Size in bytes of the weights and biases of a network file (the input weights and hidden biases, the output weights and the output bias)
+static const size_t networkSize = 2 * ((size_t)Nnue::inputSize * Nnue::hiddenSize + Nnue::hiddenSize) + 2 * Nnue::hiddenSize + 2;
+
+// Read a little endian 32 bit number
+static uint32_t readLittleEndian32(const uint8_t* bytes)
+{
+	return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+// Compute the 32 bit FNV-1a hash of the given bytes
+static uint32_t fnv1aHash(const uint8_t* bytes, const size_t size)
+{
+	uint32_t hash = 2166136261u;
+	for (size_t i = 0; i < size; i++)
+		hash = (hash ^ bytes[i]) * 16777619u;
+
+	return hash;
+}
+
+Nnue::Nnue() : inputWeights(nullptr), hiddenBiases(nullptr), outputWeights(nullptr), outputBias(0), baseAddress(nullptr), mappingSize(0) {}
+
+Nnue::~Nnue()
+{
+	this->close();
+}
+
+bool Nnue::load(const std::string& path)
+{
+	this->close();
+
+	void* view = nullptr;
+	size_t size = 0;
+
+#if defined(_WIN32)
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	LARGE_INTEGER fileSize;
+	if (file != INVALID_HANDLE_VALUE && GetFileSizeEx(file, &fileSize))
+	{
+		// The view keeps the mapping alive after its handles are closed
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping)
+		{
+			view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			size = (size_t)fileSize.QuadPart;
+			CloseHandle(mapping);
+		}
+	}
+	if (file != INVALID_HANDLE_VALUE)
+		CloseHandle(file);
+#else
+	int file = ::open(path.c_str(), O_RDONLY);
+	struct stat fileStatus;
+	if (file >= 0 && fstat(file, &fileStatus) == 0 && fileStatus.st_size > 0)
+	{
+		view = mmap(nullptr, (size_t)fileStatus.st_size, PROT_READ, MAP_SHARED, file, 0);
+		size = (size_t)fileStatus.st_size;
+		if (view == MAP_FAILED)
+			view = nullptr;
+	}
+	if (file >= 0)
+		::close(file);
+#endif
+
+	this->baseAddress = view;
+	this->mappingSize = size;
+
+	// The header has to name this format and this network size, and the hash has to match so a damaged file is refused (the trainers pad it to a multiple of 64 bytes)
+	const uint8_t* bytes = (const uint8_t*)view;
+	if (view && (size < headerSize + networkSize || size >= headerSize + networkSize + 64 || std::memcmp(bytes, "CBNN", 4) != 0 ||
+		readLittleEndian32(bytes + 4) != fileVersion || readLittleEndian32(bytes + 8) != (uint32_t)hiddenSize ||
+		readLittleEndian32(bytes + 12) != fnv1aHash(bytes + headerSize, networkSize)))
+		this->close();
+
+	if (!this->baseAddress)
+		return false;
+
+	// The weights are used where they are in the mapping, the output bias is copied as it may not be aligned
+	this->inputWeights = (const int16_t*)(bytes + headerSize);
+	this->hiddenBiases = this->inputWeights + inputSize * hiddenSize;
+	this->outputWeights = (const int8_t*)(this->hiddenBiases + hiddenSize);
+	const uint8_t* biasBytes = (const uint8_t*)(this->outputWeights + 2 * hiddenSize);
+	this->outputBias = (int16_t)(biasBytes[0] | (biasBytes[1] << 8));
+
+	return true;
+}
+
+void Nnue::close()
+{
+	if (this->baseAddress)
+	{
+#if defined(_WIN32)
+		UnmapViewOfFile(this->baseAddress);
+#else
+		munmap(this->baseAddress, this->mappingSize);
+#endif
+	}
+
+	this->baseAddress = nullptr;
+	this->mappingSize = 0;
+	this->inputWeights = nullptr;
+	this->hiddenBiases = nullptr;
+	this->outputWeights = nullptr;
+	this->outputBias = 0;
+}
+
+bool Nnue::isLoaded() const
+{
+	return this->baseAddress != nullptr;
+}
+
+void Nnue::resetAccumulator(Accumulator& accumulator) const
+{
+	for (int perspective = 0; perspective < 2; perspective++)
+		for (int i = 0; i < hiddenSize; i++)
+			accumulator.values[perspective][i] = this->hiddenBiases[i];
+}
+
+void Nnue::updateAccumulator(Accumulator& accumulator, const Piece piece, const Square square, const int sign) const
+{
+	for (int perspective = 0; perspective < 2; perspective++)
+	{
+		const int16_t* weights = this->inputWeights + inputIndex(piece, square, perspective) * hiddenSize;
+		if (sign > 0)
+			kernels.addWeights(accumulator.values[perspective], weights);
+		else
+			kernels.subtractWeights(accumulator.values[perspective], weights);
+	}
+}
+
+int Nnue::evaluate(const Accumulator& accumulator, const Piece::Color sideToMove) const
+{
+	int perspective = sideToMove == Piece::Color::WHITE ? 0 : 1;
+	// The products of the output layer are scaled by both the activations and the output weights while the bias is only scaled by the output weights
+	int64_t output = (int64_t)kernels.output(accumulator.values[perspective], accumulator.values[1 - perspective], this->outputWeights) + (int64_t)this->outputBias * activationScale;
+
+	return (int)(output * evaluationScale / (activationScale * outputWeightScale));
+}
+
+const char* Nnue::instructionSet()
+{
+	return kernels.name;
+}
+
+int Nnue::inputIndex(const Piece piece, const Square square, const int perspective)
+{
+	// White numbers the squares from a1 so the rows of the board are flipped, black sees the board from the other side
+	int colorIndex = piece.getColor() == Piece::Color::WHITE ? 0 : 1;
+	Square inputSquare = perspective == 0 ? mirrorSquare(square) : square;
+
+	return (colorIndex == perspective ? 0 : 384) + inputType[piece.getType()] * 64 + inputSquare;
+}
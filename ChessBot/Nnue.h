@@ -0,0 +1,84 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "Piece.h"
+#include "Square.h"
+
+// Efficiently updatable neural network evaluator read from a memory mapped file, every piece on its square is an input seen from the point of view of both players,
+// the hidden layer of each point of view is kept in an accumulator that the board updates as pieces are added and removed so an evaluation only has to compute the output
+class Nnue
+{
+public:
+	// Number of inputs of each point of view (the 6 piece types of both colors on the 64 squares)
+	static const int inputSize = 768;
+
+	// Number of neurons of the hidden layer of each point of view
+	static const int hiddenSize = 256;
+
+	// The hidden layer values are clipped to the range from 0 to this value (the scale of the input weights), they fit in a signed byte
+	// so two of them multiplied with 8 bit output weights and added can not overflow the 16 bits of the vector instructions
+	static const int activationScale = 127;
+
+	// The scale of the 8 bit output weights and of the output bias
+	static const int outputWeightScale = 64;
+
+	// The version of the network file format
+	static const uint32_t fileVersion = 1;
+
+	// Factor that turns the output of the network into centipawns
+	static const int evaluationScale = 400;
+
+	// Hidden layer values before the activation of both points of view (index 0 for white and index 1 for black)
+	class Accumulator
+	{
+	public:
+		int16_t values[2][hiddenSize];
+	};
+
+	// Construct an evaluator without a network
+	Nnue();
+
+	// Unmap the network file
+	~Nnue();
+
+	Nnue(const Nnue&) = delete;
+	Nnue& operator =(const Nnue&) = delete;
+
+	// Map a network file, returns false and keeps no network if the file can not be used. All numbers are little endian: a 16 byte header ("CBNN", the file version,
+	// the hidden layer size and the FNV-1a hash of the rest of the file before the padding), then the input weights and the hidden biases as 16 bit numbers,
+	// the output weights of both points of view as 8 bit numbers and the output bias as a 16 bit number (the file can be padded to a multiple of 64 bytes)
+	bool load(const std::string& path);
+
+	// Unmap the network file
+	void close();
+
+	// Returns true if a network is loaded
+	bool isLoaded() const;
+
+	// Set the accumulator to the hidden biases (the accumulator of an empty board)
+	void resetAccumulator(Accumulator& accumulator) const;
+
+	// Add the inputs of a piece on the given square to the accumulator (sign 1), or remove them (sign -1)
+	void updateAccumulator(Accumulator& accumulator, const Piece piece, const Square square, const int sign) const;
+
+	// Compute the evaluation in centipawns from the point of view of the player to move
+	int evaluate(const Accumulator& accumulator, const Piece::Color sideToMove) const;
+
+	// Get the name of the instruction set picked for this processor (avx2, sse2 or scalar)
+	static const char* instructionSet();
+
+private:
+	// Weights of every input (hiddenSize numbers each), biases of the hidden layer, weights of the output (the player to move first) and bias of the output inside the mapping
+	const int16_t* inputWeights;
+	const int16_t* hiddenBiases;
+	const int8_t* outputWeights;
+	int16_t outputBias;
+
+	// The mapping of the file (null if no network is loaded)
+	void* baseAddress;
+	size_t mappingSize;
+
+	// Get the input of a piece on the given square seen from the point of view of the given color index (own pieces first, squares numbered from a1 and mirrored for black)
+	static int inputIndex(const Piece piece, const Square square, const int perspective);
+};
@@ -0,0 +1,87 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <random>
+#include <string>
+#include "Board.h"
+
+// Opening book in the Polyglot format that is memory mapped so every engine process reading the same file shares its pages
+class OpeningBook
+{
+public:
+	// A position of the Polyglot reference given by the moves played from the starting position with its known key
+	struct ReferenceKey
+	{
+		// Short description of the position
+		const char* name;
+		// The moves in long algebraic notation separated by spaces
+		const char* moves;
+		// The correct key
+		uint64_t key;
+	};
+
+	// Construct a book without a file
+	OpeningBook();
+
+	// Unmap the book file
+	~OpeningBook();
+
+	OpeningBook(const OpeningBook&) = delete;
+	OpeningBook& operator =(const OpeningBook&) = delete;
+
+	// Map the Polyglot book at the given path (replacing the current one), returns false if it can not be used
+	bool open(const std::string& path);
+
+	// Unmap the current book file
+	void close();
+
+	// Returns true if a book file is mapped
+	bool isOpen() const;
+
+	// Pick one of the book moves of the position on the board with a probability proportional to its weight, returns the empty move if the position is not in the book
+	Move probe(const Board& board);
+
+	// Get the Polyglot hash key of the position on the board
+	static uint64_t polyglotKey(const Board& board);
+
+	// Compute the key of every reference position, write the result of each one and return true if all keys are correct
+	static bool runKeySuite(std::ostream& output);
+
+private:
+	// Size of a book entry in bytes: key (8), move (2), weight (2) and learn data (4), all big endian
+	static const int entrySize = 16;
+
+	// The first byte of the mapped file
+	const unsigned char* data;
+
+	// The number of entries of the book (the entries are sorted by key)
+	size_t entryCount;
+
+	// Size of the mapping in bytes
+	size_t mappingSize;
+
+#if defined(_WIN32)
+	// Handles of the book file and of its mapping
+	void* fileHandle;
+	void* mappingHandle;
+#endif
+
+	// Random number generator used to choose between the moves of a position
+	std::mt19937 random;
+
+	// Get the key of the entry with the given index
+	uint64_t entryKey(const size_t index) const;
+
+	// Get the move of the entry with the given index
+	uint16_t entryMove(const size_t index) const;
+
+	// Get the weight of the entry with the given index
+	uint16_t entryWeight(const size_t index) const;
+
+	// Find the legal move of the board that matches a move in the Polyglot encoding (castling is encoded as the king capturing its rook)
+	static Move decodeMove(const Board& board, const uint16_t bookMove);
+
+	// Positions of the Polyglot format description with their keys
+	static const ReferenceKey referenceKeys[];
+};
@@ -0,0 +1,10 @@
+#include "PawnHashTable.h"
+
+PawnHashTable::Entry::Entry() : key(0), middlegameValue(0), endgameValue(0) {}
+
+PawnHashTable::PawnHashTable() : entries(entryCount) {}
+
+PawnHashTable::Entry& PawnHashTable::getEntry(const uint64_t pawnHash)
+{
+	return this->entries[pawnHash & (entryCount - 1)];
+}
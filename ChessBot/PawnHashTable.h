@@ -0,0 +1,33 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+
+// Cache of pawn structure evaluations indexed by the pawn hash of the board, every search thread has its own so it needs no synchronization
+class PawnHashTable
+{
+public:
+	class Entry
+	{
+	public:
+		// The pawn hash of the stored structure
+		uint64_t key;
+		// The middle game and end game values of the pawn structure (positive values favour white)
+		int middlegameValue;
+		int endgameValue;
+		// Construct an empty entry (it is also the correct entry of boards without pawns, whose pawn hash is 0)
+		Entry();
+	};
+
+	// Construct an empty table
+	PawnHashTable();
+
+	// Get the entry the structure with the given pawn hash is stored in (its key is different if the structure has not been stored yet)
+	Entry& getEntry(const uint64_t pawnHash);
+
+private:
+	// The number of entries (a power of two so the low bits of the hash can be used as the index)
+	static const int entryCount = 16384;
+
+	// The entries of the table
+	std::vector<Entry> entries;
+};
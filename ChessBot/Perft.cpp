@@ -0,0 +1,107 @@
+#include "Perft.h"
+#include <chrono>
+#include <memory>
+
+const Perft::ReferencePosition Perft::referencePositions[] =
+{
+	{ "Initial position", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 5, 4865609ULL },
+	{ "Kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 4, 4085603ULL },
+	{ "Rook endgame", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 5, 674624ULL },
+	{ "Promotions and castling", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 4, 422333ULL },
+	{ "Mirrored promotions and castling", "r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1", 4, 422333ULL },
+	{ "Discovered checks", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 4, 2103487ULL }
+};
+
+// Get the time passed since the given moment in milliseconds
+static double millisecondsSince(const std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+Perft::Perft(Board& board) : board(board) {}
+
+uint64_t Perft::count(const int depth)
+{
+	if (depth == 0)
+		return 1;
+
+	Piece::Color playerToMove = this->board.getPlayerToMove();
+	MoveList moves;
+	this->board.getMoves(playerToMove, moves);
+
+	// The generated moves are legal so the last depth is just the number of moves
+	if (depth == 1)
+		return (uint64_t)moves.size();
+
+	uint64_t nodes = 0;
+	for (const Move move : moves)
+	{
+		this->board.makeMove(move);
+		nodes += this->count(depth - 1);
+		this->board.undoMove();
+	}
+
+	return nodes;
+}
+
+uint64_t Perft::divide(const int depth, std::ostream& output)
+{
+	auto start = std::chrono::steady_clock::now();
+	Piece::Color playerToMove = this->board.getPlayerToMove();
+
+	MoveList moves;
+	this->board.getMoves(playerToMove, moves);
+
+	uint64_t nodes = 0;
+	for (const Move move : moves)
+	{
+		this->board.makeMove(move);
+		uint64_t moveNodes = depth > 1 ? this->count(depth - 1) : 1;
+		output << move.toAlgebraicString() << ": " << moveNodes << "\n";
+		nodes += moveNodes;
+		this->board.undoMove();
+	}
+
+	double milliseconds = millisecondsSince(start);
+	output << "\nNodes: " << nodes << "\n";
+	output << "Time: " << (int64_t)milliseconds << " ms\n";
+	output << "Nodes/second: " << (uint64_t)(nodes * 1000.0 / (milliseconds > 0 ? milliseconds : 1)) << "\n";
+
+	return nodes;
+}
+
+bool Perft::runSuite(std::ostream& output)
+{
+	bool allCorrect = true;
+	uint64_t totalNodes = 0;
+	double totalMilliseconds = 0;
+
+	// The board is loaded with every position in turn
+	std::unique_ptr<Board> board(new Board());
+	Perft perft(*board);
+
+	for (const ReferencePosition& position : referencePositions)
+	{
+		board->loadFen(position.fen);
+
+		auto start = std::chrono::steady_clock::now();
+		uint64_t nodes = perft.count(position.depth);
+		double milliseconds = millisecondsSince(start);
+
+		bool correct = nodes == position.nodes;
+		allCorrect = allCorrect && correct;
+		totalNodes += nodes;
+		totalMilliseconds += milliseconds;
+
+		output << (correct ? "OK     " : "FAILED ") << position.name << ", depth " << position.depth << ": " << nodes;
+		if (!correct)
+			output << " (expected " << position.nodes << ")";
+		output << " in " << (int64_t)milliseconds << " ms\n";
+	}
+
+	output << "\nTotal nodes: " << totalNodes << "\n";
+	output << "Total time: " << (int64_t)totalMilliseconds << " ms\n";
+	output << "Nodes/second: " << (uint64_t)(totalNodes * 1000.0 / (totalMilliseconds > 0 ? totalMilliseconds : 1)) << "\n";
+
+	return allCorrect;
+}
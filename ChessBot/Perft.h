@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include "Board.h"
+
+// Counts the leaf nodes of the legal move tree of a board to check the move generation and measure its speed
+class Perft
+{
+public:
+	// A position with the known number of leaf nodes at some depth
+	struct ReferencePosition
+	{
+		// Short description of the position
+		const char* name;
+		// FEN of the position
+		const char* fen;
+		// The depth of the count
+		int depth;
+		// The correct number of leaf nodes
+		uint64_t nodes;
+	};
+
+	// Construct a perft counter that works on the given board (the board is left unchanged after every count)
+	Perft(Board& board);
+
+	// Count the leaf nodes of the legal move tree of the given depth
+	uint64_t count(const int depth);
+
+	// Count the leaf nodes under every legal move of the given depth and write them, the total, the time and the nodes per second
+	uint64_t divide(const int depth, std::ostream& output);
+
+	// Run every reference position, write the result of each one and return true if all node counts are correct
+	static bool runSuite(std::ostream& output);
+
+private:
+	Board& board;
+
+	// Standard positions with known node counts
+	static const ReferencePosition referencePositions[];
+};
@@ -1,7 +1,7 @@
 #pragma once
-#include <vector>
-#include "Position.h"
+#include <cstdint>
 
+// A piece packed in one byte (the type in the low 3 bits and the color in the next 2), the board keeps track of where it stands
 class Piece
 {
 public:
@@ -26,11 +26,9 @@ public:
 	};
 
 	// Construct an empty piece
-	Piece();
-	// Construct an empty piece with a given position
-	Piece(Position position);
-	// Construct a piece given a type, a color, a position and a hasMoved value
-	Piece(Piece::Type type, Piece::Color color, Position position, bool hasMoved = false);
+	constexpr Piece() : code(0) {}
+	// Construct a piece given a type and a color
+	constexpr Piece(const Piece::Type type, const Piece::Color color) : code((uint8_t)(type | (color << 3))) {}
 
 	// Get the type of the piece
 	Piece::Type getType() const;
@@ -40,25 +38,9 @@ public:
 	// Get the color of the piece
 	Piece::Color getColor() const;
 
-	// Get the position of the piece
-	Position getPosition() const;
-
-	// Check if the piece has moved before (true if it did, false otherwise)
-	bool hasMoved() const;
-
-	// Set the hasMoved value of the piece
-	void setHasMoved(const bool newHasMoved);
-
-	// Move the piece to a given position
-	void move(Position targetPosition);
-
-	// Check if this piece has the same position as the other
+	// Check if this piece has the same type and color as the other
 	bool operator ==(const Piece& other) const;
 
 private:
-	Piece::Type type;
-	Piece::Color color;
-	Position position;
-	bool _hasMoved;
+	uint8_t code;
 };
-
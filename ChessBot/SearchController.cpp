@@ -0,0 +1,71 @@
+#include "SearchController.h"
+
+SearchController::SearchController() : stopped(false), nodeCount(0), nodeLimit(0), maxDepth(0), infinite(false), hasDeadline(false), deadline(std::chrono::steady_clock::now()) {}
+
+void SearchController::reset()
+{
+	std::lock_guard<std::mutex> lock(this->mutex);
+	this->stopped.store(false, std::memory_order_relaxed);
+}
+
+void SearchController::start(const SearchLimits& limits, const int64_t timeLimit)
+{
+	std::lock_guard<std::mutex> lock(this->mutex);
+
+	this->nodeCount.store(0, std::memory_order_relaxed);
+	this->nodeLimit = limits.nodes;
+	this->maxDepth = limits.depth;
+	this->infinite = limits.infinite;
+	this->hasDeadline = timeLimit >= 0;
+	this->deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeLimit > 0 ? timeLimit : 0);
+}
+
+void SearchController::stop()
+{
+	{
+		// The flag is changed while holding the lock so the waiting thread can not miss the notification
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->stopped.store(true, std::memory_order_relaxed);
+	}
+
+	this->condition.notify_all();
+}
+
+bool SearchController::isStopped() const
+{
+	return this->stopped.load(std::memory_order_relaxed);
+}
+
+void SearchController::addNodes(const uint64_t count)
+{
+	uint64_t totalNodes = this->nodeCount.fetch_add(count, std::memory_order_relaxed) + count;
+
+	if (this->nodeLimit > 0 && totalNodes >= this->nodeLimit && !this->isStopped())
+		this->stop();
+}
+
+uint64_t SearchController::nodes() const
+{
+	return this->nodeCount.load(std::memory_order_relaxed);
+}
+
+int SearchController::depthLimit() const
+{
+	return this->maxDepth;
+}
+
+bool SearchController::isInfinite() const
+{
+	return this->infinite;
+}
+
+void SearchController::waitForStop()
+{
+	std::unique_lock<std::mutex> lock(this->mutex);
+	auto isStopped = [this]() { return this->stopped.load(std::memory_order_relaxed); };
+
+	if (this->hasDeadline)
+		this->condition.wait_until(lock, this->deadline, isStopped);
+	else
+		this->condition.wait(lock, isStopped);
+}
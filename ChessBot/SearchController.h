@@ -0,0 +1,68 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include "SearchLimits.h"
+
+// Stop signal, node count and limits of a search shared by all the search threads
+class SearchController
+{
+public:
+	// Construct a controller for a search without limits
+	SearchController();
+
+	// Clear the stop signal for a new search (called before the search thread is started, so a stop that arrives before the search starts is not lost)
+	void reset();
+
+	// Start a new search with the depth and node limits of the given limits that must stop after the given number of milliseconds (-1 for no deadline)
+	void start(const SearchLimits& limits, const int64_t timeLimit);
+
+	// Stop the search and wake up the thread waiting for it
+	void stop();
+
+	// Returns true if the search has been stopped (relaxed load, the search threads only check it every few nodes)
+	bool isStopped() const;
+
+	// Add nodes searched by one of the threads to the node count and stop the search once the node limit is reached
+	void addNodes(const uint64_t count);
+
+	// Get the number of nodes searched by all the threads
+	uint64_t nodes() const;
+
+	// Get the maximum depth of the search (0 if there is no limit)
+	int depthLimit() const;
+
+	// Returns true if the search only ends with the stop command (go infinite)
+	bool isInfinite() const;
+
+	// Block the calling thread until the search is stopped or the deadline is reached
+	void waitForStop();
+
+private:
+	// True once the search has to stop
+	std::atomic<bool> stopped;
+
+	// The number of nodes searched by all the threads
+	std::atomic<uint64_t> nodeCount;
+
+	// The maximum number of nodes (0 if there is no limit)
+	uint64_t nodeLimit;
+
+	// The maximum depth (0 if there is no limit)
+	int maxDepth;
+
+	// True if the search goes on until it is stopped
+	bool infinite;
+
+	// True if the search has to stop at the deadline
+	bool hasDeadline;
+
+	// The time the search has to stop at
+	std::chrono::steady_clock::time_point deadline;
+
+	// Used together with the condition variable to wake up the waiting thread as soon as the search stops
+	std::mutex mutex;
+	std::condition_variable condition;
+};
@@ -0,0 +1,3 @@
+#include "SearchLimits.h"
+
+SearchLimits::SearchLimits() : depth(0), nodes(0), moveTime(0), time{ 0, 0 }, increment{ 0, 0 }, movesToGo(0), infinite(false) {}
@@ -0,0 +1,26 @@
+#pragma once
+#include <cstdint>
+#include "Piece.h"
+
+// Limits of a search given by the go command (a value of 0 means the limit is not set)
+class SearchLimits
+{
+public:
+	// The maximum depth of the search
+	int depth;
+	// The maximum number of nodes searched
+	uint64_t nodes;
+	// The exact time in milliseconds the search can take
+	int moveTime;
+	// The time left on the clock of each player in milliseconds (index 0 for white, index 1 for black)
+	int time[2];
+	// The time added to the clock of each player after every move in milliseconds (index 0 for white, index 1 for black)
+	int increment[2];
+	// The number of moves until the next time control (0 if the whole game has to be played with the time left)
+	int movesToGo;
+	// True if the search should go on until it is stopped
+	bool infinite;
+
+	// Construct limits for a search that goes on until it is stopped
+	SearchLimits();
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+// Index of a square of the board from 0 to 63 (row * 8 + column, row 0 is the eighth rank and column 0 is the a file)
+typedef int Square;
+
+// Changes of the square index for one step in each direction (up is towards the eighth rank)
+enum Direction
+{
+	UP = -8,
+	DOWN = 8,
+	LEFT = -1,
+	RIGHT = 1,
+	UP_LEFT = UP + LEFT,
+	UP_RIGHT = UP + RIGHT,
+	DOWN_LEFT = DOWN + LEFT,
+	DOWN_RIGHT = DOWN + RIGHT
+};
+
+// Get the index of the square at the given row and column
+constexpr Square squareIndex(const int row, const int column)
+{
+	return row * 8 + column;
+}
+
+// Get the row of a square
+constexpr int squareRow(const Square square)
+{
+	return square >> 3;
+}
+
+// Get the column of a square
+constexpr int squareColumn(const Square square)
+{
+	return square & 7;
+}
+
+// Check if a row and a column are on the board
+constexpr bool isOnBoard(const int row, const int column)
+{
+	return 0 <= row && row < 8 && 0 <= column && column < 8;
+}
+
+// Get the square one step away in the given direction (the square must not be on the edge the step crosses)
+constexpr Square shiftSquare(const Square square, const Direction direction)
+{
+	return square + direction;
+}
+
+// Get the square on the same column and the mirrored row (used to read the tables of white from the point of view of black)
+constexpr Square mirrorSquare(const Square square)
+{
+	return square ^ 56;
+}
@@ -0,0 +1,1199 @@
+#include "Tablebases.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include "SearchLimits.h"
+
+#if defined(_WIN32)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// The files number the squares from a1 (0) to h8 (63) and the pieces from 1 to 6 for pawn, knight, bishop, rook, queen and king (plus 8 for black)
+static const Piece::Type boardType[8] = { Piece::Type::NONE, Piece::Type::PAWN, Piece::Type::KNIGHT, Piece::Type::BISHOP, Piece::Type::ROOK, Piece::Type::QUEEN, Piece::Type::KING, Piece::Type::NONE };
+
+// Letters of the pieces in the file names, from the strongest to the weakest
+static const char pieceLetters[] = "QRBNP";
+
+// Flags of the parts of the files
+static const int playerFlag = 1;
+static const int mappedFlag = 2;
+static const int winPliesFlag = 4;
+static const int lossPliesFlag = 8;
+static const int wideFlag = 16;
+static const int constantFlag = 128;
+
+// Numbers of the squares and of the sets of squares used by the indexes of the files
+class SquareNumbers
+{
+public:
+	// The squares of the a1-d1-d4 triangle: the six below the a1-h8 diagonal from b1 first and the four on the diagonal last (-1 outside the triangle)
+	int triangle[64];
+	// The 28 squares below the a1-h8 diagonal from b1 to h7 (-1 elsewhere)
+	int belowDiagonal[64];
+	// The 462 positions of two kings with the first one in the triangle (-1 for the positions that can not happen or are mirrored along the diagonal)
+	int kings[10][64];
+	// Order of the squares a pawn can stand on: the a and h files first, then the b and g files and so on, from the second rank up with the queen side first (a2 is 47, e7 is 0)
+	int pawnOrder[64];
+	// Number of ways to choose k of n squares
+	uint64_t binomial[8][65];
+	// Number of the first position of the leading pawns with the leading one on a square of the a to d files, for every number of leading pawns
+	uint64_t leadPawnStart[7][64];
+	// Number of positions of the leading pawns with the leading one on each of the a to d files
+	uint64_t leadPawnPositions[7][4];
+
+	SquareNumbers();
+};
+
+// Distance of a square from the a1-h8 diagonal (positive above it, towards a8)
+static int diagonalDistance(const int square)
+{
+	return (square >> 3) - (square & 7);
+}
+
+// Mirror a square along the a1-h8 diagonal
+static int transpose(const int square)
+{
+	return ((square & 7) << 3) | (square >> 3);
+}
+
+SquareNumbers::SquareNumbers()
+{
+	for (int n = 0; n <= 64; n++)
+		for (int k = 0; k < 8; k++)
+			this->binomial[k][n] = k == 0 ? 1 : n == 0 ? 0 : this->binomial[k - 1][n - 1] + this->binomial[k][n - 1];
+
+	int triangleSquares[10];
+	int triangleCount = 0;
+	for (int square = 0; square < 64; square++)
+	{
+		this->triangle[square] = -1;
+		this->belowDiagonal[square] = -1;
+		if ((square & 7) < 4 && diagonalDistance(square) < 0)
+			triangleSquares[triangleCount++] = square;
+	}
+	for (int row = 0; row < 4; row++)
+		triangleSquares[triangleCount++] = row * 9;
+	for (int number = 0; number < 10; number++)
+		this->triangle[triangleSquares[number]] = number;
+
+	int belowCount = 0;
+	for (int square = 0; square < 64; square++)
+		if (diagonalDistance(square) < 0)
+			this->belowDiagonal[square] = belowCount++;
+
+	// With the first king on the diagonal the position is mirrored so the second one is not above it, the positions with both kings on the diagonal come last
+	int code = 0;
+	std::vector<std::pair<int, int>> bothOnDiagonal;
+	for (int number = 0; number < 10; number++)
+	{
+		int firstKing = triangleSquares[number];
+		for (int square = 0; square < 64; square++)
+		{
+			this->kings[number][square] = -1;
+			bool touching = std::abs((square >> 3) - (firstKing >> 3)) <= 1 && std::abs((square & 7) - (firstKing & 7)) <= 1;
+			if (touching || (diagonalDistance(firstKing) == 0 && diagonalDistance(square) > 0))
+				continue;
+
+			if (diagonalDistance(firstKing) == 0 && diagonalDistance(square) == 0)
+				bothOnDiagonal.push_back(std::make_pair(number, square));
+			else
+				this->kings[number][square] = code++;
+		}
+	}
+	for (const std::pair<int, int>& position : bothOnDiagonal)
+		this->kings[position.first][position.second] = code++;
+
+	for (int square = 0; square < 64; square++)
+	{
+		int rank = square >> 3, file = square & 7;
+		int fileGroup = std::min(file, 7 - file);
+		this->pawnOrder[square] = rank == 0 || rank == 7 ? -1 : 47 - 12 * fileGroup - 2 * (rank - 1) - (file > 3 ? 1 : 0);
+	}
+
+	// The other leading pawns have a lower order than the leading one, so each square of the leading one has that many positions
+	for (int count = 1; count < 7; count++)
+		for (int file = 0; file < 4; file++)
+		{
+			uint64_t start = 0;
+			for (int rank = 1; rank < 7; rank++)
+			{
+				this->leadPawnStart[count][rank * 8 + file] = start;
+				start += this->binomial[count - 1][this->pawnOrder[rank * 8 + file]];
+			}
+			this->leadPawnPositions[count][file] = start;
+		}
+}
+
+static const SquareNumbers numbers;
+
+// Read little endian numbers from the files
+static uint32_t readLittleEndian(const uint8_t* bytes, const int count)
+{
+	uint32_t value = 0;
+	for (int i = count - 1; i >= 0; i--)
+		value = (value << 8) | bytes[i];
+
+	return value;
+}
+
+// Read big endian numbers from the files
+static uint64_t readBigEndian(const uint8_t* bytes, const int count)
+{
+	uint64_t value = 0;
+	for (int i = 0; i < count; i++)
+		value = (value << 8) | bytes[i];
+
+	return value;
+}
+
+// Get the first and the second symbol of a symbol (12 bits each)
+static int firstSymbol(const uint8_t* pairs, const int symbol)
+{
+	const uint8_t* pair = pairs + 3 * symbol;
+	return ((pair[1] & 0xF) << 8) | pair[0];
+}
+
+static int secondSymbol(const uint8_t* pairs, const int symbol)
+{
+	const uint8_t* pair = pairs + 3 * symbol;
+	return (pair[2] << 4) | (pair[1] >> 4);
+}
+
+// Get the distance of the move before a capture or pawn move from the result after it
+static int distanceBeforeZeroing(const Tablebases::Wdl wdl)
+{
+	return wdl == Tablebases::Wdl::WIN ? 1 :
+		wdl == Tablebases::Wdl::CURSED_WIN ? 101 :
+		wdl == Tablebases::Wdl::BLESSED_LOSS ? -101 :
+		wdl == Tablebases::Wdl::LOSS ? -1 : 0;
+}
+
+// Get the sign of a number (-1, 0 or 1)
+static int sign(const int value)
+{
+	return (value > 0) - (value < 0);
+}
+
+// Returns true if the move captures a piece
+static bool isCapture(const Board& board, const Move move)
+{
+	return move.getFlag() == Move::Flag::EN_PASSANT || board.getPiece(move.getTargetSquare()).getType() != Piece::Type::NONE;
+}
+
+// Returns true if the move is a capture or a pawn move, which starts the count of the fifty move rule again
+static bool isZeroing(const Board& board, const Move move)
+{
+	return isCapture(board, move) || board.getPiece(move.getInitialSquare()).getType() == Piece::Type::PAWN;
+}
+
+// Returns true if the player to move is mated
+static bool isMated(Board& board)
+{
+	Piece::Color player = board.getPlayerToMove();
+	if (!board.isInCheck(player))
+		return false;
+
+	MoveList moves;
+	board.getMoves(player, moves);
+	return moves.empty();
+}
+
+// Add the squares of the pieces of a kind to the list in the numbering of the files, returns the new size of the list
+// (the board numbers the rows from the eighth rank and the files the ranks from the first one, unless the colors are swapped which flips the ranks again)
+static int addSquares(const Board& board, const int pieceCode, const bool swapColors, int squares[], int count, const int capacity)
+{
+	Piece::Color color = ((pieceCode & 8) != 0) != swapColors ? Piece::Color::BLACK : Piece::Color::WHITE;
+	Bitboard pieces = board.getPieces(boardType[pieceCode & 7], color);
+	while (pieces && count < capacity)
+	{
+		Square square = popLeastSignificantSquare(pieces);
+		squares[count++] = swapColors ? square : mirrorSquare(square);
+	}
+
+	return count;
+}
+
+// Unmap a file mapped in memory
+static void unmapFile(void* address, const size_t size)
+{
+#if defined(_WIN32)
+	(void)size;
+	UnmapViewOfFile(address);
+#else
+	munmap(address, size);
+#endif
+}
+
+Tablebases::CompressedValues::CompressedValues() : constant(true), constantValue(0), blockSizeBits(0), spanBits(0), spans(nullptr), spanCount(0), blockLengths(nullptr),
+	blockLengthCount(0), blocks(nullptr), blockCount(0), minCodeLength(0), firstSymbols(nullptr), symbolPairs(nullptr) {}
+
+bool Tablebases::CompressedValues::readHeader(const uint8_t* file, const size_t size, size_t& position, const uint64_t positionCount, const bool distance)
+{
+	if (size - position < 2)
+		return false;
+	const uint8_t* data = file + position;
+
+	// A part with the same value everywhere only stores it after the flags (distance files always use 0)
+	if (data[0] & constantFlag)
+	{
+		this->constant = true;
+		this->constantValue = distance ? 0 : data[1];
+		position += 2;
+		return true;
+	}
+
+	if (size - position < 12)
+		return false;
+	this->constant = false;
+	this->blockSizeBits = data[1];
+	this->spanBits = data[2];
+	int paddingBlocks = data[3];
+	this->blockCount = readLittleEndian(data + 4, 4);
+	int maxCodeLength = data[8];
+	this->minCodeLength = data[9];
+	if (this->spanBits < 1 || this->spanBits > 40 || this->blockSizeBits > 30 || this->minCodeLength < 1 || maxCodeLength < this->minCodeLength || maxCodeLength > 63)
+		return false;
+
+	int lengthCount = maxCodeLength - this->minCodeLength + 1;
+	if (size - position < 12 + 2 * (size_t)lengthCount)
+		return false;
+	this->firstSymbols = data + 10;
+	int symbolCount = (int)readLittleEndian(data + 10 + 2 * lengthCount, 2);
+	this->symbolPairs = data + 12 + 2 * lengthCount;
+	size_t headerSize = 12 + 2 * (size_t)lengthCount + 3 * (size_t)symbolCount + (symbolCount & 1);
+	if (size - position < headerSize)
+		return false;
+	position += headerSize;
+
+	this->spanCount = (size_t)((positionCount + (1ULL << this->spanBits) - 1) >> this->spanBits);
+	this->blockLengthCount = this->blockCount + paddingBlocks;
+
+	this->symbolSizes.assign(symbolCount, 0);
+	for (int symbol = 0; symbol < symbolCount; symbol++)
+		if (this->countValues(symbol) <= 0)
+			return false;
+
+	// The codes of each length are consecutive numbers that start after the codes of the next longer length (shortened by one bit),
+	// the number of codes of a length is the difference between its first symbol and the one of the next length
+	this->lowestCodes.assign(lengthCount, 0);
+	for (int i = lengthCount - 2; i >= 0; i--)
+	{
+		uint64_t longerCodes = readLittleEndian(this->firstSymbols + 2 * i, 2) - (uint64_t)readLittleEndian(this->firstSymbols + 2 * (i + 1), 2);
+		this->lowestCodes[i] = (this->lowestCodes[i + 1] + longerCodes) / 2;
+	}
+	for (int i = 0; i < lengthCount; i++)
+		this->lowestCodes[i] <<= 64 - (this->minCodeLength + i);
+
+	return true;
+}
+
+int Tablebases::CompressedValues::countValues(const int symbol)
+{
+	// A size of -1 marks a symbol being counted, so a broken file that makes a symbol contain itself is noticed
+	int& values = this->symbolSizes[symbol];
+	if (values != 0)
+		return values;
+
+	int second = secondSymbol(this->symbolPairs, symbol);
+	if (second == 0xFFF)
+		return values = 1;
+
+	int first = firstSymbol(this->symbolPairs, symbol);
+	if (first >= (int)this->symbolSizes.size() || second >= (int)this->symbolSizes.size())
+		return values = -1;
+
+	values = -1;
+	int firstValues = this->countValues(first);
+	int secondValues = this->countValues(second);
+	return values = firstValues > 0 && secondValues > 0 ? firstValues + secondValues : -1;
+}
+
+int Tablebases::CompressedValues::get(const uint64_t index) const
+{
+	if (this->constant)
+		return this->constantValue;
+
+	// The entry of the span of the index gives the block and the position in it of the middle of the span, the value may be in a block before or after it
+	const uint8_t* span = this->spans + 6 * (size_t)(index >> this->spanBits);
+	uint32_t block = readLittleEndian(span, 4);
+	int64_t position = (int64_t)readLittleEndian(span + 4, 2) + (int64_t)(index & ((1ULL << this->spanBits) - 1)) - (int64_t)(1ULL << (this->spanBits - 1));
+	while (position < 0)
+		position += readLittleEndian(this->blockLengths + 2 * (size_t)--block, 2) + 1;
+	while (position > (int64_t)readLittleEndian(this->blockLengths + 2 * (size_t)block, 2))
+		position -= readLittleEndian(this->blockLengths + 2 * (size_t)block++, 2) + 1;
+
+	// Read the codes of the block until the symbol that holds the value, the next bits of the block are kept at the top of a 64 bit number
+	const uint8_t* next = this->blocks + ((size_t)block << this->blockSizeBits);
+	uint64_t bits = readBigEndian(next, 8);
+	next += 8;
+	int bitCount = 64;
+	int symbol;
+	while (true)
+	{
+		int length = this->minCodeLength;
+		while (bits < this->lowestCodes[length - this->minCodeLength])
+			length++;
+		symbol = (int)readLittleEndian(this->firstSymbols + 2 * (length - this->minCodeLength), 2) + (int)((bits - this->lowestCodes[length - this->minCodeLength]) >> (64 - length));
+
+		if (position < this->symbolSizes[symbol])
+			break;
+		position -= this->symbolSizes[symbol];
+
+		bits <<= length;
+		bitCount -= length;
+		if (bitCount <= 32)
+		{
+			bits |= readBigEndian(next, 4) << (32 - bitCount);
+			next += 4;
+			bitCount += 32;
+		}
+	}
+
+	// Go down the pairs of the symbol to the single value
+	while (this->symbolSizes[symbol] > 1)
+	{
+		int first = firstSymbol(this->symbolPairs, symbol);
+		if (position < this->symbolSizes[first])
+			symbol = first;
+		else
+		{
+			position -= this->symbolSizes[first];
+			symbol = secondSymbol(this->symbolPairs, symbol);
+		}
+	}
+
+	return firstSymbol(this->symbolPairs, symbol);
+}
+
+Tablebases::Part::Part() : pieces(), positionCount(0), flags(0), distanceMaps() {}
+
+void Tablebases::Part::readPieces(const uint8_t* orders, const uint8_t* pieceCodes, const int pieceCount, const int shift, const int leadSize, const int otherPawns, const int column)
+{
+	for (int i = 0; i < pieceCount; i++)
+		this->pieces[i] = (pieceCodes[i] >> shift) & 0xF;
+
+	// The leading group, then the pawns of the other color, then every run of pieces of the same kind
+	this->groups.clear();
+	this->groups.push_back(Group{ 0, leadSize, 0 });
+	int start = leadSize;
+	if (otherPawns > 0)
+	{
+		this->groups.push_back(Group{ start, otherPawns, 0 });
+		start += otherPawns;
+	}
+	while (start < pieceCount)
+	{
+		int size = 1;
+		while (start + size < pieceCount && this->pieces[start + size] == this->pieces[start])
+			size++;
+		this->groups.push_back(Group{ start, size, 0 });
+		start += size;
+	}
+
+	// The file gives the place of the leading group and of the other pawns in the index, the other groups fill the remaining places in turn
+	// and each one chooses its squares among the ones the groups before it do not use
+	int leadOrder = (orders[0] >> shift) & 0xF;
+	int otherPawnsOrder = otherPawns > 0 ? (orders[1] >> shift) & 0xF : -1;
+	int freeSquares = 64 - leadSize - otherPawns;
+	size_t nextGroup = otherPawns > 0 ? 2 : 1;
+	uint64_t factor = 1;
+	for (int place = 0; nextGroup < this->groups.size() || place == leadOrder || place == otherPawnsOrder; place++)
+	{
+		if (place == leadOrder)
+		{
+			this->groups[0].factor = factor;
+			factor *= column >= 0 ? numbers.leadPawnPositions[leadSize][column] : leadSize == 3 ? 31332 : 462;
+		}
+		else if (place == otherPawnsOrder)
+		{
+			this->groups[1].factor = factor;
+			factor *= numbers.binomial[otherPawns][48 - leadSize];
+		}
+		else
+		{
+			Group& group = this->groups[nextGroup++];
+			group.factor = factor;
+			factor *= numbers.binomial[group.size][freeSquares];
+			freeSquares -= group.size;
+		}
+	}
+
+	this->positionCount = factor;
+}
+
+Tablebases::TableFile::TableFile() : distance(false), usable(false), baseAddress(nullptr), mappingSize(0), bothPlayers(false) {}
+
+Tablebases::TableFile::~TableFile()
+{
+	if (this->baseAddress)
+		unmapFile(this->baseAddress, this->mappingSize);
+}
+
+void Tablebases::TableFile::open(const Material& material)
+{
+	void* view = nullptr;
+	size_t size = 0;
+
+#if defined(_WIN32)
+	HANDLE file = CreateFileA(this->path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+	LARGE_INTEGER fileSize;
+	if (file != INVALID_HANDLE_VALUE && GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0)
+	{
+		// The view keeps the mapping alive after its handles are closed
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping)
+		{
+			view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			size = (size_t)fileSize.QuadPart;
+			CloseHandle(mapping);
+		}
+	}
+	if (file != INVALID_HANDLE_VALUE)
+		CloseHandle(file);
+#else
+	int file = ::open(this->path.c_str(), O_RDONLY);
+	struct stat fileStatus;
+	if (file >= 0 && fstat(file, &fileStatus) == 0 && fileStatus.st_size > 0)
+	{
+		view = mmap(nullptr, (size_t)fileStatus.st_size, PROT_READ, MAP_SHARED, file, 0);
+		size = (size_t)fileStatus.st_size;
+		if (view == MAP_FAILED)
+			view = nullptr;
+	}
+	if (file >= 0)
+		::close(file);
+#endif
+
+	if (!view)
+		return;
+	this->baseAddress = view;
+	this->mappingSize = size;
+
+	// Every file starts with a magic number of its kind
+	static const uint8_t wdlMagic[4] = { 0x71, 0xE8, 0x23, 0x5D };
+	static const uint8_t distanceMagic[4] = { 0xD7, 0x66, 0x0C, 0xA5 };
+	this->usable = size > 5 && std::memcmp(view, this->distance ? distanceMagic : wdlMagic, 4) == 0 && this->read(material);
+
+	if (!this->usable)
+	{
+		unmapFile(this->baseAddress, this->mappingSize);
+		this->baseAddress = nullptr;
+		this->mappingSize = 0;
+	}
+}
+
+bool Tablebases::TableFile::read(const Material& material)
+{
+	const uint8_t* file = (const uint8_t*)this->baseAddress;
+	size_t size = this->mappingSize;
+
+	// After the magic number a byte tells if the material has pawns (then there is a part for each file of the leading pawn) and if both players to move are stored
+	bool pawns = (file[4] & 2) != 0;
+	if (pawns != (material.leadPawns > 0))
+		return false;
+	this->bothPlayers = !this->distance && (file[4] & 1) != 0;
+	int columns = pawns ? 4 : 1;
+	int players = this->bothPlayers ? 2 : 1;
+	size_t position = 5;
+
+	// The pieces of every column follow their orders, the low nibbles are the ones of white to move and the high nibbles the ones of black to move
+	int orderCount = material.otherPawns > 0 ? 2 : 1;
+	if (size - position < (size_t)columns * (orderCount + material.pieceCount))
+		return false;
+	for (int column = 0; column < columns; column++)
+	{
+		const uint8_t* orders = file + position;
+		const uint8_t* pieceCodes = orders + orderCount;
+		for (int i = 0; i < material.pieceCount; i++)
+			for (int player = 0; player < players; player++)
+				if (boardType[(pieceCodes[i] >> (4 * player)) & 7] == Piece::Type::NONE)
+					return false;
+
+		for (int player = 0; player < players; player++)
+			this->parts[column][player].readPieces(orders, pieceCodes, material.pieceCount, 4 * player, material.leadSize, material.otherPawns, pawns ? column : -1);
+		position += orderCount + material.pieceCount;
+	}
+	position += position & 1;
+
+	for (int column = 0; column < columns; column++)
+		for (int player = 0; player < players; player++)
+		{
+			Part& part = this->parts[column][player];
+			if (position >= size)
+				return false;
+			part.flags = file[position];
+			if (!part.values.readHeader(file, size, position, part.positionCount, this->distance))
+				return false;
+		}
+
+	// Distance files can map the stored values of each result to the distances
+	if (this->distance)
+	{
+		for (int column = 0; column < columns; column++)
+		{
+			Part& part = this->parts[column][0];
+			if (!(part.flags & mappedFlag))
+				continue;
+
+			if (part.flags & wideFlag)
+				position += position & 1;
+			int valueSize = part.flags & wideFlag ? 2 : 1;
+			for (int result = 0; result < 4; result++)
+			{
+				if (position > size || size - position < (size_t)valueSize)
+					return false;
+				part.distanceMaps[result] = file + position + valueSize;
+				position += valueSize * (1 + (size_t)readLittleEndian(file + position, valueSize));
+			}
+		}
+		position += position & 1;
+	}
+
+	// Then come the spans, the block lengths and the blocks of every part (the blocks are aligned to 64 bytes)
+	for (int column = 0; column < columns; column++)
+		for (int player = 0; player < players; player++)
+		{
+			CompressedValues& values = this->parts[column][player].values;
+			values.spans = file + std::min(position, size);
+			position += 6 * values.spanCount;
+		}
+	for (int column = 0; column < columns; column++)
+		for (int player = 0; player < players; player++)
+		{
+			CompressedValues& values = this->parts[column][player].values;
+			values.blockLengths = file + std::min(position, size);
+			position += 2 * values.blockLengthCount;
+		}
+	for (int column = 0; column < columns; column++)
+		for (int player = 0; player < players; player++)
+		{
+			CompressedValues& values = this->parts[column][player].values;
+			position = (position + 63) & ~(size_t)63;
+			values.blocks = file + std::min(position, size);
+			position += values.blockCount << values.blockSizeBits;
+		}
+
+	return position <= size;
+}
+
+Tablebases::Material::Material(const std::string& name) : name(name), pieceCount((int)name.size() - 1), leadPawns(0), otherPawns(0)
+{
+	size_t separator = name.find('v');
+	std::string sides[2] = { name.substr(0, separator), name.substr(separator + 1) };
+	this->symmetric = sides[0] == sides[1];
+
+	// The leading pawns are the ones of the color with fewer pawns (but at least one), white if both have as many
+	int pawns[2];
+	for (int side = 0; side < 2; side++)
+		pawns[side] = (int)std::count(sides[side].begin(), sides[side].end(), 'P');
+	bool blackLeads = pawns[1] > 0 && (pawns[0] == 0 || pawns[1] < pawns[0]);
+	this->leadPawns = blackLeads ? pawns[1] : pawns[0];
+	this->otherPawns = blackLeads ? pawns[0] : pawns[1];
+
+	// Without pawns the two kings lead, or three pieces if a player has a piece that is the only one of its kind
+	int uniqueKinds = 0;
+	for (const std::string& side : sides)
+		for (const char letter : std::string("KQRBN"))
+			uniqueKinds += std::count(side.begin(), side.end(), letter) == 1 ? 1 : 0;
+	this->leadSize = this->leadPawns > 0 ? this->leadPawns : uniqueKinds > 2 ? 3 : 2;
+
+	this->wdl.distance = false;
+	this->dtz.distance = true;
+}
+
+Tablebases::Tablebases() : largestMaterial(0) {}
+
+Tablebases::~Tablebases() {}
+
+void Tablebases::setPath(const std::string& paths)
+{
+	this->materials.clear();
+	this->directories.clear();
+	this->largestMaterial = 0;
+
+	if (paths.empty() || paths == "<empty>")
+		return;
+
+#if defined(_WIN32)
+	const char separator = ';';
+#else
+	const char separator = ':';
+#endif
+	size_t start = 0;
+	while (start <= paths.size())
+	{
+		size_t end = paths.find(separator, start);
+		if (end == std::string::npos)
+			end = paths.size();
+		if (end > start)
+			this->directories.push_back(paths.substr(start, end - start));
+		start = end + 1;
+	}
+
+	// Every material with a win/draw/loss file can be probed, its distance file may be in another directory or missing (then only the distance probes fail)
+	for (const std::string& directory : this->directories)
+		for (const std::string& name : listFiles(directory, ".rtbw"))
+		{
+			if (!isMaterialName(name) || this->materials.count(name))
+				continue;
+
+			Material* material = new Material(name);
+			material->wdl.path = directory + "/" + name + ".rtbw";
+			this->materials[name] = std::unique_ptr<Material>(material);
+			this->largestMaterial = std::max(this->largestMaterial, material->pieceCount);
+		}
+
+	for (const std::string& directory : this->directories)
+		for (const std::string& name : listFiles(directory, ".rtbz"))
+		{
+			auto entry = this->materials.find(name);
+			if (entry != this->materials.end() && entry->second->dtz.path.empty())
+				entry->second->dtz.path = directory + "/" + name + ".rtbz";
+		}
+}
+
+int Tablebases::maxPieces() const
+{
+	return this->largestMaterial;
+}
+
+std::vector<std::string> Tablebases::listFiles(const std::string& directory, const std::string& extension)
+{
+	std::vector<std::string> fileNames;
+
+#if defined(_WIN32)
+	WIN32_FIND_DATAA entry;
+	HANDLE search = FindFirstFileA((directory + "\\*" + extension).c_str(), &entry);
+	if (search != INVALID_HANDLE_VALUE)
+	{
+		do
+			fileNames.push_back(entry.cFileName);
+		while (FindNextFileA(search, &entry));
+		FindClose(search);
+	}
+#else
+	DIR* listing = opendir(directory.c_str());
+	if (listing)
+	{
+		while (dirent* entry = readdir(listing))
+			fileNames.push_back(entry->d_name);
+		closedir(listing);
+	}
+#endif
+
+	// Keep the names with the extension, without it
+	std::vector<std::string> names;
+	for (const std::string& fileName : fileNames)
+		if (fileName.size() > extension.size() && fileName.compare(fileName.size() - extension.size(), extension.size(), extension) == 0)
+			names.push_back(fileName.substr(0, fileName.size() - extension.size()));
+
+	return names;
+}
+
+bool Tablebases::isMaterialName(const std::string& name)
+{
+	size_t separator = name.find('v');
+	if (separator == std::string::npos || name.size() - 1 > (size_t)maxTablePieces)
+		return false;
+
+	// Each side is a king followed by its other pieces from the strongest to the weakest
+	std::string sides[2] = { name.substr(0, separator), name.substr(separator + 1) };
+	for (const std::string& side : sides)
+	{
+		if (side.empty() || side[0] != 'K')
+			return false;
+		for (size_t i = 1; i < side.size(); i++)
+		{
+			const char* letter = side[i] != '\0' ? std::strchr(pieceLetters, side[i]) : nullptr;
+			if (!letter || (i > 1 && letter < std::strchr(pieceLetters, side[i - 1])))
+				return false;
+		}
+	}
+
+	return true;
+}
+
+std::string Tablebases::sideName(const Board& board, const Piece::Color color)
+{
+	static const Piece::Type types[5] = { Piece::Type::QUEEN, Piece::Type::ROOK, Piece::Type::BISHOP, Piece::Type::KNIGHT, Piece::Type::PAWN };
+
+	std::string name = "K";
+	for (int i = 0; i < 5; i++)
+		name.append(popCount(board.getPieces(types[i], color)), pieceLetters[i]);
+
+	return name;
+}
+
+bool Tablebases::findPosition(const Board& board, const bool distance, const Part*& part, uint64_t& index, bool& otherPlayer)
+{
+	// The white pieces of the file are the pieces before the 'v', which may be the black pieces of the board
+	std::string whiteSide = sideName(board, Piece::Color::WHITE);
+	std::string blackSide = sideName(board, Piece::Color::BLACK);
+	bool swapColors = false;
+	auto entry = this->materials.find(whiteSide + "v" + blackSide);
+	if (entry == this->materials.end())
+	{
+		swapColors = true;
+		entry = this->materials.find(blackSide + "v" + whiteSide);
+		if (entry == this->materials.end())
+			return false;
+	}
+
+	Material& material = *entry->second;
+	TableFile& file = distance ? material.dtz : material.wdl;
+	if (file.path.empty())
+		return false;
+	std::call_once(file.opened, [&file, &material]() { file.open(material); });
+	if (!file.usable)
+		return false;
+
+	// A symmetric material is always read with white to move
+	bool blackToMove = board.getPlayerToMove() == Piece::Color::BLACK;
+	if (material.symmetric)
+		swapColors = blackToMove;
+	int player = material.symmetric ? 0 : blackToMove != swapColors ? 1 : 0;
+
+	// The leading pawn is the one with the highest order, its file chooses the part
+	int squares[maxTablePieces];
+	int count = 0;
+	int column = 0;
+	if (material.leadPawns > 0)
+	{
+		count = addSquares(board, file.parts[0][0].pieces[0], swapColors, squares, 0, material.leadPawns);
+		for (int i = 1; i < count; i++)
+			if (numbers.pawnOrder[squares[i]] > numbers.pawnOrder[squares[0]])
+				std::swap(squares[0], squares[i]);
+		column = std::min(squares[0] & 7, 7 - (squares[0] & 7));
+	}
+
+	part = &file.parts[column][file.bothPlayers ? player : 0];
+	otherPlayer = distance && (part->flags & playerFlag) != player && !(material.symmetric && material.leadPawns == 0);
+
+	// The pieces of a kind are next to each other in the order of the part
+	while (count < material.pieceCount)
+	{
+		int added = addSquares(board, part->pieces[count], swapColors, squares, count, material.pieceCount);
+		if (added == count)
+			return false;
+		count = added;
+	}
+
+	index = material.leadPawns > 0 ? pawnIndex(*part, squares, count) : pieceIndex(*part, squares, count);
+	return index < part->positionCount;
+}
+
+uint64_t Tablebases::pieceIndex(const Part& part, int squares[], const int count)
+{
+	// The position is turned so the first piece is in the a1-d1-d4 triangle and the first leading piece off the a1-h8 diagonal is below it
+	int flip = ((squares[0] & 7) > 3 ? 7 : 0) | ((squares[0] >> 3) > 3 ? 56 : 0);
+	for (int i = 0; i < count; i++)
+		squares[i] ^= flip;
+
+	int leadSize = part.groups[0].size;
+	for (int i = 0; i < leadSize; i++)
+	{
+		if (diagonalDistance(squares[i]) == 0)
+			continue;
+		if (diagonalDistance(squares[i]) > 0)
+			for (int j = i; j < count; j++)
+				squares[j] = transpose(squares[j]);
+		break;
+	}
+
+	uint64_t index;
+	if (leadSize == 2)
+		index = numbers.kings[numbers.triangle[squares[0]]][squares[1]];
+	else
+	{
+		// Three leading pieces: the first one off the diagonal is below it, and a piece can not stand on the squares of the pieces before it
+		int first = squares[0], second = squares[1], third = squares[2];
+		int secondSkips = second > first ? 1 : 0;
+		int thirdSkips = (third > first ? 1 : 0) + (third > second ? 1 : 0);
+		if (diagonalDistance(first) != 0)
+			index = numbers.triangle[first] * 63 * 62 + (second - secondSkips) * 62 + third - thirdSkips;
+		else if (diagonalDistance(second) != 0)
+			index = 6 * 63 * 62 + (first >> 3) * 28 * 62 + numbers.belowDiagonal[second] * 62 + third - thirdSkips;
+		else if (diagonalDistance(third) != 0)
+			index = 6 * 63 * 62 + 4 * 28 * 62 + (first >> 3) * 7 * 28 + ((second >> 3) - secondSkips) * 28 + numbers.belowDiagonal[third];
+		else
+			index = 6 * 63 * 62 + 4 * 28 * 62 + 4 * 7 * 28 + (first >> 3) * 7 * 6 + ((second >> 3) - secondSkips) * 6 + (third >> 3) - thirdSkips;
+	}
+
+	return index * part.groups[0].factor + groupsIndex(part, squares, 1, -1);
+}
+
+uint64_t Tablebases::pawnIndex(const Part& part, int squares[], const int count)
+{
+	// The position is mirrored so the leading pawn is on the a to d files
+	if ((squares[0] & 7) > 3)
+		for (int i = 0; i < count; i++)
+			squares[i] ^= 7;
+
+	// The other leading pawns are numbered as a set of squares with a lower order than the leading one
+	int leadSize = part.groups[0].size;
+	std::sort(squares + 1, squares + leadSize, [](const int first, const int second) { return numbers.pawnOrder[first] < numbers.pawnOrder[second]; });
+	uint64_t index = numbers.leadPawnStart[leadSize][squares[0]];
+	for (int i = 1; i < leadSize; i++)
+		index += numbers.binomial[i][numbers.pawnOrder[squares[i]]];
+
+	int otherPawnsGroup = part.groups.size() > 1 && (part.pieces[part.groups[1].start] & 7) == 1 ? 1 : -1;
+	return index * part.groups[0].factor + groupsIndex(part, squares, 1, otherPawnsGroup);
+}
+
+uint64_t Tablebases::groupsIndex(const Part& part, int squares[], const int firstGroup, const int otherPawnsGroup)
+{
+	// Every group is numbered as a set of squares among the ones the groups before it in the order of the pieces leave free (pawns only use the ranks 2 to 7)
+	uint64_t index = 0;
+	for (int g = firstGroup; g < (int)part.groups.size(); g++)
+	{
+		const Group& group = part.groups[g];
+		std::sort(squares + group.start, squares + group.start + group.size);
+
+		uint64_t number = 0;
+		for (int i = 0; i < group.size; i++)
+		{
+			int square = squares[group.start + i];
+			int freeBefore = g == otherPawnsGroup ? square - 8 : square;
+			for (int j = 0; j < group.start; j++)
+				freeBefore -= squares[j] < square ? 1 : 0;
+			number += numbers.binomial[i + 1][freeBefore];
+		}
+		index += number * group.factor;
+	}
+
+	return index;
+}
+
+bool Tablebases::readWdl(const Board& board, Wdl& wdl)
+{
+	// Two bare kings have no file
+	if (board.getPieceCount() == 2)
+	{
+		wdl = Wdl::DRAW;
+		return true;
+	}
+
+	const Part* part;
+	uint64_t index;
+	bool otherPlayer;
+	if (!this->findPosition(board, false, part, index, otherPlayer))
+		return false;
+
+	wdl = (Wdl)(part->values.get(index) - 2);
+	return true;
+}
+
+Tablebases::Lookup Tablebases::readDtz(const Board& board, const Wdl wdl, int& dtz)
+{
+	const Part* part;
+	uint64_t index;
+	bool otherPlayer;
+	if (!this->findPosition(board, true, part, index, otherPlayer))
+		return Lookup::MISSING;
+	if (otherPlayer)
+		return Lookup::OTHER_PLAYER;
+
+	dtz = part->values.get(index);
+
+	// The stored values of each result can be mapped to the distances (the maps are in the order win, loss, cursed win, blessed loss)
+	if (part->flags & mappedFlag)
+	{
+		static const int mapOfResult[5] = { 1, 3, 0, 2, 0 };
+		const uint8_t* map = part->distanceMaps[mapOfResult[wdl + 2]];
+		dtz = part->flags & wideFlag ? (int)readLittleEndian(map + 2 * dtz, 2) : map[dtz];
+	}
+
+	// The distances are stored in moves unless the flag of a win or a loss says they are in plies
+	bool inPlies = (wdl == Wdl::WIN && (part->flags & winPliesFlag)) || (wdl == Wdl::LOSS && (part->flags & lossPliesFlag));
+	if (!inPlies)
+		dtz *= 2;
+
+	return Lookup::FOUND;
+}
+
+bool Tablebases::searchCaptures(Board& board, int alpha, const int beta, Wdl& wdl, bool& captureIsBest)
+{
+	MoveList moves;
+	board.getMoves(board.getPlayerToMove(), moves);
+	int captureCount = 0;
+	captureIsBest = false;
+
+	for (const Move move : moves)
+	{
+		if (!isCapture(board, move))
+			continue;
+
+		captureCount++;
+		board.makeMove(move);
+		Wdl reply;
+		bool replyCaptureIsBest;
+		bool found = this->searchCaptures(board, -beta, -alpha, reply, replyCaptureIsBest);
+		board.undoMove();
+
+		if (!found)
+			return false;
+
+		if (-reply > alpha)
+		{
+			alpha = -reply;
+			if (alpha >= beta)
+			{
+				wdl = (Wdl)alpha;
+				captureIsBest = true;
+				return true;
+			}
+		}
+	}
+
+	// If every move is a capture the file is not needed (it has no en passant rights, so it may not know the only moves)
+	if (captureCount > 0 && captureCount == moves.size())
+	{
+		wdl = (Wdl)alpha;
+		captureIsBest = true;
+		return true;
+	}
+
+	Wdl stored;
+	if (!this->readWdl(board, stored))
+		return false;
+
+	// The file can store any result that is not better than the best capture
+	if (alpha >= stored)
+	{
+		wdl = (Wdl)alpha;
+		captureIsBest = alpha > Wdl::DRAW;
+	}
+	else
+		wdl = stored;
+
+	return true;
+}
+
+bool Tablebases::probeWdl(Board& board, Wdl& wdl)
+{
+	bool captureIsBest;
+	return this->searchCaptures(board, Wdl::LOSS, Wdl::WIN, wdl, captureIsBest);
+}
+
+bool Tablebases::probeDtz(Board& board, int& dtz)
+{
+	Wdl wdl;
+	bool captureIsBest;
+	dtz = 0;
+	if (!this->searchCaptures(board, Wdl::LOSS, Wdl::WIN, wdl, captureIsBest))
+		return false;
+	if (wdl == Wdl::DRAW)
+		return true;
+
+	// The count of the fifty move rule starts again after a capture, so the best capture is one ply away from it
+	if (captureIsBest)
+	{
+		dtz = distanceBeforeZeroing(wdl);
+		return true;
+	}
+
+	MoveList moves;
+	board.getMoves(board.getPlayerToMove(), moves);
+
+	// The same goes for a pawn move that keeps the win
+	if (wdl > Wdl::DRAW)
+		for (const Move move : moves)
+		{
+			if (isCapture(board, move) || board.getPiece(move.getInitialSquare()).getType() != Piece::Type::PAWN)
+				continue;
+
+			board.makeMove(move);
+			Wdl reply;
+			bool replyCaptureIsBest;
+			bool found = this->searchCaptures(board, Wdl::LOSS, -wdl + 1, reply, replyCaptureIsBest);
+			board.undoMove();
+
+			if (!found)
+				return false;
+			if (-reply == wdl)
+			{
+				dtz = distanceBeforeZeroing(wdl);
+				return true;
+			}
+		}
+
+	int stored;
+	Lookup lookup = this->readDtz(board, wdl, stored);
+	if (lookup == Lookup::MISSING)
+		return false;
+
+	// A cursed win or a blessed loss is counted past the hundred plies of the fifty move rule
+	if (lookup == Lookup::FOUND)
+	{
+		dtz = (1 + stored + (wdl == Wdl::CURSED_WIN || wdl == Wdl::BLESSED_LOSS ? 100 : 0)) * sign(wdl);
+		return true;
+	}
+
+	// The file only stores the other player to move, so the distance is one more than the best distance after a move
+	if (wdl > Wdl::DRAW)
+	{
+		// The shortest way to keep the win (the zeroing moves were tried above)
+		int minimumDistance = INT32_MAX;
+		for (const Move move : moves)
+		{
+			if (isZeroing(board, move))
+				continue;
+
+			board.makeMove(move);
+			int moveDistance;
+			bool found = this->probeDtz(board, moveDistance);
+			bool mate = found && isMated(board);
+			board.undoMove();
+
+			if (!found)
+				return false;
+			if (mate)
+				minimumDistance = 1;
+			else if (moveDistance < 0)
+				minimumDistance = std::min(minimumDistance, -moveDistance + 1);
+		}
+
+		if (minimumDistance == INT32_MAX)
+			return false;
+		dtz = minimumDistance;
+	}
+	else
+	{
+		// The longest way to lose, a capture or pawn move ends the count at once (and one that turns a blessed loss into a loss does not count)
+		int minimumDistance = -1;
+		for (const Move move : moves)
+		{
+			bool zeroing = isZeroing(board, move);
+			board.makeMove(move);
+			int moveDistance;
+			bool found;
+			if (!zeroing)
+			{
+				found = this->probeDtz(board, moveDistance);
+				moveDistance = -moveDistance - 1;
+			}
+			else if (wdl == Wdl::LOSS)
+			{
+				found = true;
+				moveDistance = -1;
+			}
+			else
+			{
+				Wdl reply;
+				bool replyCaptureIsBest;
+				found = this->searchCaptures(board, Wdl::CURSED_WIN, Wdl::WIN, reply, replyCaptureIsBest);
+				moveDistance = reply == Wdl::WIN ? 0 : -101;
+			}
+			board.undoMove();
+
+			if (!found)
+				return false;
+			minimumDistance = std::min(minimumDistance, moveDistance);
+		}
+
+		dtz = minimumDistance;
+	}
+
+	return true;
+}
+
+bool Tablebases::probeRoot(Board& board, Move& bestMove, Wdl& wdl)
+{
+	if (!this->probeWdl(board, wdl))
+		return false;
+
+	MoveList moves;
+	board.getMoves(board.getPlayerToMove(), moves);
+	int halfmoveClock = board.getHalfmoveClock();
+	int bestRank = INT32_MIN;
+	bestMove = Move();
+
+	for (const Move move : moves)
+	{
+		board.makeMove(move);
+
+		// The distance of the move counted from the root (a capture or pawn move starts the fifty move count again)
+		int distance;
+		bool found;
+		if (board.getHalfmoveClock() == 0)
+		{
+			Wdl moveWdl;
+			found = this->probeWdl(board, moveWdl);
+			distance = distanceBeforeZeroing((Wdl)-moveWdl);
+		}
+		else
+		{
+			found = this->probeDtz(board, distance);
+			distance = -distance;
+			distance = distance > 0 ? distance + 1 : distance < 0 ? distance - 1 : 0;
+		}
+
+		// A mating move has a distance of one
+		if (found && distance == 2 && isMated(board))
+			distance = 1;
+
+		board.undoMove();
+
+		if (!found)
+			return false;
+
+		// Wins reached before the fifty move rule are best (the shortest first), then wins after it, draws, losses after the rule and losses before it (the longest first)
+		int rank = distance > 0 ? (distance + halfmoveClock <= 99 ? 3000 - distance : 1000 - (distance + halfmoveClock)) :
+			distance < 0 ? (-distance * 2 + halfmoveClock < 100 ? -3000 - distance : -1000 + (-distance + halfmoveClock)) : 0;
+
+		if (rank > bestRank)
+		{
+			bestRank = rank;
+			bestMove = move;
+		}
+	}
+
+	return !(bestMove == Move());
+}
+
+bool Tablebases::runFallbackSuite(std::ostream& output)
+{
+	// No path, the UCI default, and a directory that does not exist
+	static const char* const paths[] = { "", "<empty>", "no-such-syzygy-directory" };
+
+	bool allCorrect = true;
+	for (const char* path : paths)
+	{
+		// An ending of three pieces that every set of tablebases has
+		std::unique_ptr<Board> board(new Board());
+		board->loadFen("8/8/8/4k3/8/8/8/3QK3 w - - 0 1");
+		int pieces = board->setTablebasePath(path);
+
+		Tablebases tablebases;
+		tablebases.setPath(path);
+		Wdl wdl;
+		int dtz;
+		Move move;
+		bool probed = tablebases.probeWdl(*board, wdl) || tablebases.probeDtz(*board, dtz) || tablebases.probeRoot(*board, move, wdl);
+
+		// The search has to find a legal move without them
+		SearchLimits limits;
+		limits.depth = 4;
+		board->prepareSearch();
+		Move bestMove = board->getBestMove(limits);
+		bool legal = false;
+		for (const Move legalMove : board->getMoves(board->getPlayerToMove()))
+			legal = legal || legalMove == bestMove;
+
+		bool correct = pieces == 0 && !probed && legal;
+		allCorrect = allCorrect && correct;
+
+		output << (correct ? "OK     " : "FAILED ") << "SyzygyPath \"" << path << "\": " << pieces << " pieces, probes " << (probed ? "found" : "failed")
+			<< ", search played " << bestMove.toAlgebraicString() << "\n";
+	}
+
+	return allCorrect;
+}
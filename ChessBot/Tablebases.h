@@ -0,0 +1,241 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Board.h"
+
+// Syzygy endgame tablebases read from local .rtbw (win/draw/loss) and .rtbz (distance to zeroing move) files,
+// the files are listed when the path is set but only memory mapped when a position of their material is probed first
+class Tablebases
+{
+public:
+	// Results of a win/draw/loss probe from the point of view of the player to move
+	enum Wdl
+	{
+		LOSS = -2,
+		BLESSED_LOSS = -1, // Loss that is a draw by the fifty move rule
+		DRAW = 0,
+		CURSED_WIN = 1, // Win that is a draw by the fifty move rule
+		WIN = 2
+	};
+
+	// Construct tablebases without any files
+	Tablebases();
+
+	// Unmap all the files
+	~Tablebases();
+
+	Tablebases(const Tablebases&) = delete;
+	Tablebases& operator =(const Tablebases&) = delete;
+
+	// Look for the tablebase files in the given directories (separated by ';' on Windows and ':' elsewhere, empty or "<empty>" for none), must not be called while probing
+	void setPath(const std::string& paths);
+
+	// Get the number of pieces (kings included) of the largest tablebase found, 0 if there is none
+	int maxPieces() const;
+
+	// Probe the win/draw/loss result of the position on the board (which must have no castling rights), returns false if the position is not in the tablebases
+	bool probeWdl(Board& board, Wdl& wdl);
+
+	// Probe the distance to the next capture or pawn move in plies of the position on the board (positive when winning, negative when losing, 0 for draws),
+	// returns false if the position is not in the tablebases
+	bool probeDtz(Board& board, int& dtz);
+
+	// Find the move of the player to move that keeps the best result and makes progress towards it (the shortest win or the longest loss counted with the fifty move rule),
+	// returns false if one of the positions is not in the tablebases
+	bool probeRoot(Board& board, Move& bestMove, Wdl& wdl);
+
+	// Check that the probes fail without tablebases (no path, or directories without valid files) and that the search still finds a move,
+	// writes one line per case to the output and returns true if they all pass
+	static bool runFallbackSuite(std::ostream& output);
+
+private:
+	// The maximum number of pieces of a tablebase
+	static const int maxTablePieces = 7;
+
+	// Result of reading a position in a distance file
+	enum Lookup
+	{
+		MISSING, // The file is missing or can not be read
+		FOUND,
+		OTHER_PLAYER // The file only stores the positions of the other player to move
+	};
+
+	// Pieces of the same kind whose squares are numbered together
+	struct Group
+	{
+		// Position of the first piece of the group in the order of the pieces of the file
+		int start;
+		int size;
+		// Multiplier of the number of the group in the index of a position
+		uint64_t factor;
+	};
+
+	// Values of a part of a file compressed with a canonical Huffman code, every symbol stands for a single value or for a pair of symbols
+	class CompressedValues
+	{
+	public:
+		// True if the part stores the same value for every position
+		bool constant;
+		int constantValue;
+		// Every block of the data holds 2^blockSizeBits bytes
+		int blockSizeBits;
+		// Every span of 2^spanBits values has an entry of 6 bytes that gives the block and the position in it of its middle value
+		int spanBits;
+		const uint8_t* spans;
+		size_t spanCount;
+		// Number of values minus one of every block (little endian 16 bit numbers, padded at the end so no span points after them)
+		const uint8_t* blockLengths;
+		size_t blockLengthCount;
+		// The compressed blocks
+		const uint8_t* blocks;
+		size_t blockCount;
+		// Shortest code length in bits
+		int minCodeLength;
+		// The first symbol of every code length from the shortest one (little endian 16 bit numbers)
+		const uint8_t* firstSymbols;
+		// The lowest code of every length from the shortest one, aligned to the most significant bit
+		std::vector<uint64_t> lowestCodes;
+		// The two symbols of every symbol (12 bits each in 3 bytes, a single value has 0xFFF as its second symbol and its value as the first one)
+		const uint8_t* symbolPairs;
+		// Number of values every symbol stands for
+		std::vector<int> symbolSizes;
+
+		// Construct values that are all 0
+		CompressedValues();
+
+		// Read the header of the values at the given position of the file and move the position after it, returns false if it does not fit in the file
+		bool readHeader(const uint8_t* file, const size_t size, size_t& position, const uint64_t positionCount, const bool distance);
+
+		// Decompress the value of the position with the given index
+		int get(const uint64_t index) const;
+
+	private:
+		// Count the values of a symbol and of the symbols it is made of
+		int countValues(const int symbol);
+	};
+
+	// The positions of one player to move (and one column of the leading pawn for files with pawns)
+	class Part
+	{
+	public:
+		// Pieces of the file in the order they are numbered (1 to 6 for white pawn, knight, bishop, rook, queen and king, plus 8 for black)
+		int pieces[maxTablePieces];
+		// The groups of pieces in the order of the pieces, the first one is the leading group and the second one the pawns of the other color if the leading group is made of pawns
+		std::vector<Group> groups;
+		// Number of positions of the part
+		uint64_t positionCount;
+		// Flags of the part
+		uint8_t flags;
+		// Start of the map from stored values to distances of each result (win, loss, cursed win, blessed loss) of distance files
+		const uint8_t* distanceMaps[4];
+		CompressedValues values;
+
+		// Construct an empty part
+		Part();
+
+		// Read the pieces of the part from the nibbles of its file at the given shift and compute the factors of its groups
+		// (the places of the leading group and of the other pawns in the index are in the same nibble of the order bytes, column is -1 without pawns)
+		void readPieces(const uint8_t* orders, const uint8_t* pieceCodes, const int pieceCount, const int shift, const int leadSize, const int otherPawns, const int column);
+	};
+
+	class Material;
+
+	// The win/draw/loss or the distance file of a material
+	class TableFile
+	{
+	public:
+		std::string path;
+		// True for .rtbz distance files
+		bool distance;
+		// The file is mapped and read by the first probe only
+		std::once_flag opened;
+		bool usable;
+		void* baseAddress;
+		size_t mappingSize;
+		// True if the file stores both players to move (only win/draw/loss files do)
+		bool bothPlayers;
+		// The parts of each column of the leading pawn (only the first one without pawns) and each player to move
+		Part parts[4][2];
+
+		// Construct a file that is not opened yet
+		TableFile();
+
+		// Unmap the file
+		~TableFile();
+
+		// Map the file and read the header of every part, leaves the file unusable if it can not be read
+		void open(const Material& material);
+
+	private:
+		// Read the header of every part from the mapped file, returns false if it does not fit in the file
+		bool read(const Material& material);
+	};
+
+	// A material (like KRPvKR) with its two files
+	class Material
+	{
+	public:
+		// The name of the files, the pieces before the 'v' are the white pieces of the tables
+		std::string name;
+		int pieceCount;
+		// True if both players have the same pieces
+		bool symmetric;
+		// Number of pawns of the leading color (the one with fewer pawns but at least one) and of the other color
+		int leadPawns;
+		int otherPawns;
+		// Number of pieces of the leading group (the leading pawns, or without pawns the two kings or three pieces if a piece is the only one of its kind)
+		int leadSize;
+		TableFile wdl;
+		TableFile dtz;
+
+		// Construct the material of a file name without its extension
+		explicit Material(const std::string& name);
+	};
+
+	// Directories searched for the files
+	std::vector<std::string> directories;
+
+	// Every material found by its name
+	std::unordered_map<std::string, std::unique_ptr<Material>> materials;
+
+	// Number of pieces of the largest material
+	int largestMaterial;
+
+	// List the names of the files with the given extension in a directory
+	static std::vector<std::string> listFiles(const std::string& directory, const std::string& extension);
+
+	// Check if a file name (without extension) is a material of up to seven pieces
+	static bool isMaterialName(const std::string& name);
+
+	// Get the name of the pieces of a player (like KRP)
+	static std::string sideName(const Board& board, const Piece::Color color);
+
+	// Find the part of a file that stores the position on the board and compute the index of the position in it,
+	// returns false if the material has no file or the file can not be read
+	bool findPosition(const Board& board, const bool distance, const Part*& part, uint64_t& index, bool& otherPlayer);
+
+	// Read the win/draw/loss result of the position from its file
+	bool readWdl(const Board& board, Wdl& wdl);
+
+	// Read the distance of the position with the given result from its file
+	Lookup readDtz(const Board& board, const Wdl wdl, int& dtz);
+
+	// Win/draw/loss result of the position with the captures searched first between alpha and beta (the files have no en passant rights and store any value
+	// where a capture is best), captureIsBest is set if a capture reaches the result so the stored distance can not be used
+	bool searchCaptures(Board& board, int alpha, const int beta, Wdl& wdl, bool& captureIsBest);
+
+	// Index of a position of a part without pawns from the squares of its pieces in the order of the part
+	static uint64_t pieceIndex(const Part& part, int squares[], const int count);
+
+	// Index of a position of a part with pawns from the squares of its pieces in the order of the part (the leading pawn first)
+	static uint64_t pawnIndex(const Part& part, int squares[], const int count);
+
+	// Index of the groups after the leading one
+	static uint64_t groupsIndex(const Part& part, int squares[], const int firstGroup, const int otherPawnsGroup);
+};
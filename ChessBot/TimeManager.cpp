@@ -0,0 +1,108 @@
+#include "TimeManager.h"
+
+TimeManager::TimeManager() : startTime(std::chrono::steady_clock::now()), timed(false), flexible(false), softTime(0), hardTime(0),
+	previousBestMove(), previousScore(0), stableDepths(0), completedDepths(0) {}
+
+void TimeManager::start(const SearchLimits& limits, const Piece::Color playerToMove)
+{
+	this->startTime = std::chrono::steady_clock::now();
+	this->previousBestMove = Move();
+	this->previousScore = 0;
+	this->stableDepths = 0;
+	this->completedDepths = 0;
+
+	int colorIndex = playerToMove == Piece::Color::WHITE ? 0 : 1;
+	this->timed = !limits.infinite && (limits.moveTime > 0 || limits.time[colorIndex] > 0);
+	this->flexible = false;
+
+	if (!this->timed)
+		return;
+
+	// The exact time of the search is given
+	if (limits.moveTime > 0)
+	{
+		this->softTime = this->hardTime = limits.moveTime;
+		return;
+	}
+
+	// Spread the time left over the moves until the next time control and use most of the increment
+	int64_t timeLeft = limits.time[colorIndex] - moveOverhead;
+	if (timeLeft < 1)
+		timeLeft = 1;
+
+	int movesToGo = limits.movesToGo > 0 ? limits.movesToGo : defaultMovesToGo;
+	if (movesToGo > 50)
+		movesToGo = 50;
+
+	this->softTime = timeLeft / movesToGo + limits.increment[colorIndex] * 3 / 4;
+
+	// A hard search can take a few times the normal time but never most of the clock
+	this->hardTime = this->softTime * 5;
+	if (this->hardTime > timeLeft * 4 / 5)
+		this->hardTime = timeLeft * 4 / 5;
+	if (this->softTime > this->hardTime)
+		this->softTime = this->hardTime;
+	if (this->hardTime < 1)
+		this->hardTime = this->softTime = 1;
+
+	this->flexible = true;
+}
+
+bool TimeManager::isTimed() const
+{
+	return this->timed;
+}
+
+int64_t TimeManager::elapsed() const
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - this->startTime).count();
+}
+
+int64_t TimeManager::hardLimit() const
+{
+	return this->hardTime;
+}
+
+bool TimeManager::completedDepth(const Move bestMove, const int score, const int64_t depthTime)
+{
+	this->completedDepths++;
+
+	// Count how many depths in a row agree on the best move
+	bool bestMoveChanged = this->completedDepths > 1 && !(bestMove == this->previousBestMove);
+	this->stableDepths = bestMoveChanged ? 0 : this->stableDepths + 1;
+	int scoreDrop = this->completedDepths > 1 ? this->previousScore - score : 0;
+
+	this->previousBestMove = bestMove;
+	this->previousScore = score;
+
+	if (!this->timed)
+		return false;
+
+	int64_t elapsedTime = this->elapsed();
+
+	// The next depth takes a few times longer than the last one, do not start it if it would be stopped by the hard limit anyway
+	if (elapsedTime + depthTime * 2 > this->hardTime)
+		return true;
+
+	if (!this->flexible)
+		return false;
+
+	// Spend less time when the best move keeps being the same and more when it changes or when the score drops
+	int64_t targetTime = this->softTime;
+	if (this->stableDepths >= 6)
+		targetTime = targetTime / 2;
+	else if (this->stableDepths >= 3)
+		targetTime = targetTime * 3 / 4;
+	else if (bestMoveChanged)
+		targetTime = targetTime * 13 / 10;
+
+	if (scoreDrop >= 50)
+		targetTime = targetTime * 3 / 2;
+	else if (scoreDrop >= 20)
+		targetTime = targetTime * 6 / 5;
+
+	if (targetTime > this->hardTime)
+		targetTime = this->hardTime;
+
+	return elapsedTime >= targetTime;
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include "Move.h"
+#include "SearchLimits.h"
+
+// Decides how long a search can take from the clock of the player to move and how the search has gone so far
+class TimeManager
+{
+public:
+	// Construct a time manager for a search without a time limit
+	TimeManager();
+
+	// Start timing a search with the given limits for the given player
+	void start(const SearchLimits& limits, const Piece::Color playerToMove);
+
+	// Returns true if the search has a time limit, false otherwise
+	bool isTimed() const;
+
+	// Get the number of milliseconds passed since the search started
+	int64_t elapsed() const;
+
+	// Get the number of milliseconds after which the search has to be stopped even in the middle of a depth
+	int64_t hardLimit() const;
+
+	// Record a completed depth (its best move, its score from the point of view of the player to move and how long it took) and return true if the next depth should not be started
+	bool completedDepth(const Move bestMove, const int score, const int64_t depthTime);
+
+private:
+	// The time the search started at
+	std::chrono::steady_clock::time_point startTime;
+
+	// True if the search has a time limit
+	bool timed;
+
+	// True if the time limit can be changed depending on the search (false when the exact search time is given)
+	bool flexible;
+
+	// The time in milliseconds the search should normally take
+	int64_t softTime;
+
+	// The time in milliseconds the search can never exceed
+	int64_t hardTime;
+
+	// The best move of the last completed depth
+	Move previousBestMove;
+
+	// The score of the last completed depth
+	int previousScore;
+
+	// The number of completed depths in a row that found the same best move
+	int stableDepths;
+
+	// The number of completed depths
+	int completedDepths;
+
+	// Time in milliseconds kept on the clock for the communication with the interface
+	static const int moveOverhead = 30;
+
+	// The number of moves the time left is spread over when the number of moves until the next time control is not known
+	static const int defaultMovesToGo = 40;
+};
@@ -0,0 +1,126 @@
+#include "TranspositionTable.h"
+#include <new>
+
+TranspositionTable::Entry::Entry() : move(Move()), depth(0), evaluation(0), bound(Bound::NONE) {}
+
+TranspositionTable::Entry::Entry(const Move move, const int depth, const int evaluation, const Bound bound) : move(move), depth(depth), evaluation(evaluation), bound(bound) {}
+
+// Cache line size the buckets are aligned to
+static const uintptr_t cacheLineSize = 64;
+
+TranspositionTable::TranspositionTable(const size_t megabytes) : buckets(nullptr), bucketMask(0), age(0)
+{
+	this->resize(megabytes);
+}
+
+bool TranspositionTable::resize(const size_t megabytes)
+{
+	// Use the largest power of two number of buckets that fits in the given size
+	size_t bucketCount = 1;
+	while (bucketCount * 2 * sizeof(Bucket) <= megabytes * 1024 * 1024)
+		bucketCount *= 2;
+
+	// The old table is released first so its memory can be reused, if the new size can not be allocated the table gets its previous size back
+	size_t previousBucketCount = this->buckets != nullptr ? (size_t)this->bucketMask + 1 : 1;
+	this->memory.reset();
+	this->memory.reset(new (std::nothrow) char[bucketCount * sizeof(Bucket) + cacheLineSize]);
+	bool allocated = this->memory != nullptr;
+	if (!allocated)
+	{
+		bucketCount = previousBucketCount;
+		this->memory.reset(new char[bucketCount * sizeof(Bucket) + cacheLineSize]);
+	}
+
+	this->buckets = reinterpret_cast<Bucket*>((reinterpret_cast<uintptr_t>(this->memory.get()) + cacheLineSize - 1) & ~(cacheLineSize - 1));
+	this->bucketMask = bucketCount - 1;
+
+	for (size_t i = 0; i < bucketCount; i++)
+		new (&this->buckets[i]) Bucket();
+
+	this->clear();
+	return allocated;
+}
+
+void TranspositionTable::clear()
+{
+	for (uint64_t i = 0; i <= this->bucketMask; i++)
+		for (int j = 0; j < bucketSize; j++)
+			this->buckets[i].entries[j].store(0, std::memory_order_relaxed);
+
+	this->age = 0;
+}
+
+void TranspositionTable::newSearch()
+{
+	this->age = (this->age + 1) & 0x3F;
+}
+
+uint16_t TranspositionTable::keyFragment(const uint64_t zobristHash)
+{
+	// The low bits of the hash select the bucket so the high bits are used to verify the entry
+	return (uint16_t)(zobristHash >> 48);
+}
+
+bool TranspositionTable::probe(const uint64_t zobristHash, Entry& entry) const
+{
+	const Bucket& bucket = this->buckets[zobristHash & this->bucketMask];
+	uint16_t key = keyFragment(zobristHash);
+
+	for (int i = 0; i < bucketSize; i++)
+	{
+		uint64_t data = bucket.entries[i].load(std::memory_order_relaxed);
+		Bound bound = (Bound)((data >> 40) & 0x3);
+
+		if (bound != Bound::NONE && (uint16_t)(data >> 48) == key)
+		{
+			entry = Entry(Move((uint16_t)data), (int)((data >> 32) & 0xFF), (int)(int16_t)(uint16_t)(data >> 16), bound);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void TranspositionTable::store(const uint64_t zobristHash, const Entry& entry)
+{
+	Bucket& bucket = this->buckets[zobristHash & this->bucketMask];
+	uint16_t key = keyFragment(zobristHash);
+	int replaced = -1;
+
+	// Replace the entry of the same board if there is one
+	for (int i = 0; i < bucketSize && replaced == -1; i++)
+	{
+		uint64_t data = bucket.entries[i].load(std::memory_order_relaxed);
+		if ((uint16_t)(data >> 48) != key || ((data >> 40) & 0x3) == Bound::NONE)
+			continue;
+
+		// Keep a deeper result of the same board from the current search unless the new one is exact
+		if (((data >> 42) & 0x3F) == this->age && entry.bound != Bound::EXACT && entry.depth < (int)((data >> 32) & 0xFF))
+			return;
+
+		replaced = i;
+	}
+
+	// Otherwise replace an empty entry or the entry with the least value (shallow entries of old searches go first)
+	if (replaced == -1)
+	{
+		int lowestWorth = INT32_MAX;
+		for (int i = 0; i < bucketSize; i++)
+		{
+			uint64_t data = bucket.entries[i].load(std::memory_order_relaxed);
+			int entryAge = (this->age - (int)((data >> 42) & 0x3F)) & 0x3F;
+			int worth = ((data >> 40) & 0x3) == Bound::NONE ? INT32_MIN : (int)((data >> 32) & 0xFF) - 8 * entryAge;
+
+			if (worth < lowestWorth)
+			{
+				lowestWorth = worth;
+				replaced = i;
+			}
+		}
+	}
+
+	uint64_t data = (uint64_t)entry.move.getData() | ((uint64_t)(uint16_t)(int16_t)entry.evaluation << 16) | ((uint64_t)(entry.depth & 0xFF) << 32) |
+		((uint64_t)entry.bound << 40) | ((uint64_t)this->age << 42) | ((uint64_t)key << 48);
+
+	bucket.entries[replaced].store(data, std::memory_order_relaxed);
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include "Move.h"
+
+// Hash table of search results shared by all search threads, entries are read and written without locks
+class TranspositionTable
+{
+public:
+	// Enum of the kinds of evaluations stored in the table
+	enum Bound
+	{
+		NONE = 0,
+		UPPER = 1, // The evaluation is at most the stored value (no move reached alpha)
+		LOWER = 2, // The evaluation is at least the stored value (a move reached beta)
+		EXACT = 3
+	};
+
+	class Entry
+	{
+	public:
+		// The stored move (the best move found so far for the state the board is in)
+		Move move;
+		// The depth of the search that found the stored move
+		int depth;
+		// The evaluation of the board corresponding to the stored move (stored in 16 bits)
+		int evaluation;
+		// The kind of evaluation that is stored
+		Bound bound;
+		// Construct an empty transposition table entry
+		Entry();
+		// Construct a transposition table entry given a move, a depth, an evaluation and the kind of evaluation
+		Entry(const Move move, const int depth, const int evaluation, const Bound bound);
+	};
+
+	// Construct a table that uses the given number of megabytes
+	TranspositionTable(const size_t megabytes);
+
+	// Reallocate the table to use the given number of megabytes (must not be called while searching),
+	// returns false and keeps the previous size if the memory can not be allocated
+	bool resize(const size_t megabytes);
+
+	// Remove all entries from the table
+	void clear();
+
+	// Mark the start of a new search so entries of older searches are replaced first
+	void newSearch();
+
+	// Look up the entry of the board with the given zobrist hash, returns false if there is no entry for it
+	bool probe(const uint64_t zobristHash, Entry& entry) const;
+
+	// Store an entry for the board with the given zobrist hash
+	void store(const uint64_t zobristHash, const Entry& entry);
+
+private:
+	// The number of entries of a bucket
+	static const int bucketSize = 4;
+
+	// A bucket holds the entries of all boards whose hash maps to it, each entry is a single 64 bit word so it can not be torn by threads writing at once
+	// (bits 0-15 hold the move, bits 16-31 the evaluation, bits 32-39 the depth, bits 40-41 the bound, bits 42-47 the age and bits 48-63 the top bits of the zobrist hash)
+	class Bucket
+	{
+	public:
+		std::atomic<uint64_t> entries[bucketSize];
+	};
+
+	// The memory of the table (the buckets start at the first cache line boundary inside it)
+	std::unique_ptr<char[]> memory;
+
+	// The buckets of the table
+	Bucket* buckets;
+
+	// The number of buckets minus one (the number of buckets is a power of two so this is a mask for the index)
+	uint64_t bucketMask;
+
+	// The age of the current search (6 bits)
+	uint8_t age;
+
+	// Get the part of the zobrist hash stored in an entry to tell boards that share a bucket apart
+	static uint16_t keyFragment(const uint64_t zobristHash);
+};
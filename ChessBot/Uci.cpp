@@ -0,0 +1,265 @@
+#include "Uci.h"
+#include <iostream>
+#include <algorithm>
+#include <cstdlib>
+
+Uci::Uci() : board(new Board()), hashSize(defaultHashSize), ownBook(true) {}
+
+Uci::~Uci()
+{
+	this->stopSearch();
+}
+
+void Uci::loop()
+{
+	std::string line;
+	while (std::getline(std::cin, line))
+	{
+		std::istringstream arguments(line);
+		std::string command;
+		arguments >> command;
+
+		if (command == "uci")
+		{
+			std::cout << "id name ChessBot\n";
+			std::cout << "id author Alex7342\n";
+			std::cout << "option name Hash type spin default " << defaultHashSize << " min 1 max 65536\n";
+			std::cout << "option name Threads type spin default 1 min 1 max " << maxThreads << "\n";
+			std::cout << "option name NullMovePruning type check default true\n";
+			std::cout << "option name LateMoveReductions type check default true\n";
+			std::cout << "option name ReverseFutilityPruning type check default true\n";
+			std::cout << "option name FutilityPruning type check default true\n";
+			std::cout << "option name StaticExchangePruning type check default true\n";
+			std::cout << "option name OwnBook type check default true\n";
+			std::cout << "option name BookFile type string default <empty>\n";
+			std::cout << "option name SyzygyPath type string default <empty>\n";
+			std::cout << "option name EvalFile type string default <empty>\n";
+			std::cout << "uciok" << std::endl;
+		}
+		else if (command == "isready")
+		{
+			std::cout << "readyok" << std::endl;
+		}
+		else if (command == "ucinewgame")
+		{
+			this->stopSearch();
+			this->board->loadFen(Board::startingFen);
+			this->board->setTranspositionTableSize(this->hashSize);
+		}
+		else if (command == "position")
+		{
+			this->stopSearch();
+			this->position(arguments);
+		}
+		else if (command == "go")
+		{
+			this->stopSearch();
+			this->go(arguments);
+		}
+		else if (command == "stop")
+		{
+			this->stopSearch();
+		}
+		else if (command == "setoption")
+		{
+			this->stopSearch();
+			this->setOption(arguments);
+		}
+		else if (command == "d")
+		{
+			// Not part of the protocol, shows the board for debugging
+			std::cout << this->board->toString() << "Fen: " << this->board->getFen() << std::endl;
+		}
+		else if (command == "quit")
+		{
+			break;
+		}
+	}
+}
+
+void Uci::stopSearch()
+{
+	if (this->searchThread.joinable())
+	{
+		this->board->stopSearching();
+		this->searchThread.join();
+	}
+}
+
+void Uci::position(std::istringstream& arguments)
+{
+	std::string token, fen;
+	arguments >> token;
+
+	if (token == "startpos")
+	{
+		fen = Board::startingFen;
+		arguments >> token;
+	}
+	else if (token == "fen")
+	{
+		while (arguments >> token && token != "moves")
+			fen += token + " ";
+	}
+	else
+	{
+		return;
+	}
+
+	if (!this->board->loadFen(fen))
+	{
+		std::cout << "info string invalid fen " << fen << std::endl;
+		return;
+	}
+
+	// Play the moves that follow the position
+	if (token == "moves")
+		while (arguments >> token)
+		{
+			Move move = this->parseMove(token);
+			if (move == Move())
+			{
+				std::cout << "info string illegal move " << token << std::endl;
+				return;
+			}
+
+			// Long games would fill the undo history, the moves of the game never have to be undone so their records can be dropped to leave room for the search
+			if (!this->board->hasRoomForGameMove())
+				this->board->clearHistory();
+
+			this->board->makeMove(move);
+		}
+}
+
+void Uci::go(std::istringstream& arguments)
+{
+	SearchLimits limits;
+	std::string token;
+
+	while (arguments >> token)
+	{
+		if (token == "wtime")
+			arguments >> limits.time[0];
+		else if (token == "btime")
+			arguments >> limits.time[1];
+		else if (token == "winc")
+			arguments >> limits.increment[0];
+		else if (token == "binc")
+			arguments >> limits.increment[1];
+		else if (token == "movestogo")
+			arguments >> limits.movesToGo;
+		else if (token == "movetime")
+			arguments >> limits.moveTime;
+		else if (token == "depth")
+			arguments >> limits.depth;
+		else if (token == "nodes")
+			arguments >> limits.nodes;
+		else if (token == "infinite")
+			limits.infinite = true;
+	}
+
+	// Play a move of the opening book without searching (unless the search has to go on until it is stopped)
+	if (this->ownBook && !limits.infinite)
+	{
+		Move bookMove = this->book.probe(*this->board);
+		if (!(bookMove == Move()))
+		{
+			std::cout << "bestmove " << bookMove.toAlgebraicString() << std::endl;
+			return;
+		}
+	}
+
+	// Search on another thread so the stop command can be read while searching (the search is prepared here so a stop that follows at once stops it)
+	this->board->prepareSearch();
+	this->searchThread = std::thread([this, limits]()
+	{
+		Move bestMove = this->board->getBestMove(limits);
+		std::cout << "bestmove " << (bestMove == Move() ? "0000" : bestMove.toAlgebraicString()) << std::endl;
+	});
+}
+
+void Uci::setOption(std::istringstream& arguments)
+{
+	std::string token, name, value;
+
+	// The name of the option can have several words and ends where the value starts
+	arguments >> token;
+	while (arguments >> token && token != "value")
+		name += (name.empty() ? "" : " ") + token;
+	// The value is the rest of the line so file names can have spaces
+	std::getline(arguments >> std::ws, value);
+
+	if (name == "Hash" && !value.empty())
+	{
+		int requestedSize = std::min(std::max(std::atoi(value.c_str()), 1), 65536);
+		if (this->board->setTranspositionTableSize(requestedSize))
+			this->hashSize = requestedSize;
+		else
+			std::cout << "info string could not allocate " << requestedSize << " MB for the hash table, keeping " << this->hashSize << " MB" << std::endl;
+	}
+	else if (name == "Threads" && !value.empty())
+	{
+		this->board->setThreadCount(std::min(std::max(std::atoi(value.c_str()), 1), (int)maxThreads));
+	}
+	else if (name == "OwnBook")
+	{
+		this->ownBook = value == "true";
+	}
+	else if (name == "BookFile")
+	{
+		if (value.empty() || value == "<empty>")
+			this->book.close();
+		else if (!this->book.open(value))
+			std::cout << "info string could not open the book " << value << std::endl;
+	}
+	else if (name == "SyzygyPath")
+	{
+		int maxPieces = this->board->setTablebasePath(value);
+		if (maxPieces > 0)
+			std::cout << "info string found tablebases with up to " << maxPieces << " pieces" << std::endl;
+		else if (!value.empty() && value != "<empty>")
+			std::cout << "info string no tablebases found in " << value << std::endl;
+	}
+	else if (name == "EvalFile")
+	{
+		if (!this->board->setEvalFile(value))
+			std::cout << "info string could not load the network " << value << std::endl;
+		else if (!value.empty() && value != "<empty>")
+			std::cout << "info string evaluating with the network " << value << " (" << Nnue::instructionSet() << ")" << std::endl;
+	}
+	else if (name == "NullMovePruning" || name == "LateMoveReductions" || name == "ReverseFutilityPruning" || name == "FutilityPruning" || name == "StaticExchangePruning")
+	{
+		// The selective search techniques can be turned off to compare the search with and without them
+		Board::SearchOptions options = this->board->getSearchOptions();
+		bool enabled = value == "true";
+
+		if (name == "NullMovePruning")
+			options.nullMovePruning = enabled;
+		else if (name == "LateMoveReductions")
+			options.lateMoveReductions = enabled;
+		else if (name == "ReverseFutilityPruning")
+			options.reverseFutilityPruning = enabled;
+		else if (name == "FutilityPruning")
+			options.futilityPruning = enabled;
+		else
+			options.staticExchangePruning = enabled;
+
+		this->board->setSearchOptions(options);
+	}
+	else
+	{
+		std::cout << "info string unknown option " << name << std::endl;
+	}
+}
+
+Move Uci::parseMove(const std::string& text)
+{
+	MoveList moves;
+	this->board->getMoves(this->board->getPlayerToMove(), moves);
+
+	for (const Move move : moves)
+		if (move.toAlgebraicString() == text)
+			return move;
+
+	return Move();
+}
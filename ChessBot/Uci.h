@@ -0,0 +1,58 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <sstream>
+#include <thread>
+#include "Board.h"
+#include "OpeningBook.h"
+
+// Universal Chess Interface front-end that reads commands from the standard input and answers on the standard output
+class Uci
+{
+public:
+	// Construct an engine with the default chess setup
+	Uci();
+
+	// Stop the search that is running (if there is one) before destroying the engine
+	~Uci();
+
+	// Read and execute commands until the quit command is received or the input ends
+	void loop();
+
+private:
+	// The board the engine plays on
+	std::unique_ptr<Board> board;
+
+	// Thread that runs the current search (the commands are still read while it searches)
+	std::thread searchThread;
+
+	// The size of the transposition table in megabytes
+	int hashSize;
+
+	// Opening book whose moves are played without searching
+	OpeningBook book;
+
+	// True if the moves of the opening book are used
+	bool ownBook;
+
+	// The default size of the transposition table in megabytes
+	static const int defaultHashSize = 64;
+
+	// The maximum number of search threads
+	static const int maxThreads = 256;
+
+	// Stop the current search and wait for its thread to finish
+	void stopSearch();
+
+	// Handle "position [startpos | fen <fen>] [moves <moves>]"
+	void position(std::istringstream& arguments);
+
+	// Handle "go [wtime <x>] [btime <x>] [winc <x>] [binc <x>] [movestogo <x>] [movetime <x>] [depth <x>] [nodes <x>] [infinite]"
+	void go(std::istringstream& arguments);
+
+	// Handle "setoption name <name> [value <value>]"
+	void setOption(std::istringstream& arguments);
+
+	// Find the legal move of the player to move written in long algebraic notation, returns the empty move if there is none
+	Move parseMove(const std::string& text);
+};
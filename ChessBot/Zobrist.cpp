@@ -0,0 +1,4 @@
+#include "Zobrist.h"
+
+// Computed by the compiler, the program only contains the finished table
+constexpr ZobristKeys zobristKeys = ZobristKeys();
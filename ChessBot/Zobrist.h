@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdint>
+
+// Random numbers xored into the hash of a position for every part of its state, generated at compile time so every run and every board uses the same ones
+struct ZobristKeys
+{
+	// Keys of every type of piece of each color (index 0 for white, index 1 for black) on every square
+	uint64_t pieces[2][7][64];
+
+	// Keys of the castling rights (white kingside, white queenside, black kingside, black queenside)
+	uint64_t castling[4];
+
+	// Keys of the column of the en passant square
+	uint64_t enPassant[8];
+
+	// Key of black being the player to move
+	uint64_t blackToMove;
+
+	// Fill the keys from a fixed seed
+	constexpr ZobristKeys() : pieces(), castling(), enPassant(), blackToMove(0)
+	{
+		uint64_t state = seed;
+
+		for (int color = 0; color < 2; color++)
+			for (int type = 0; type < 7; type++)
+				for (int square = 0; square < 64; square++)
+					this->pieces[color][type][square] = nextKey(state);
+
+		for (int right = 0; right < 4; right++)
+			this->castling[right] = nextKey(state);
+
+		for (int column = 0; column < 8; column++)
+			this->enPassant[column] = nextKey(state);
+
+		this->blackToMove = nextKey(state);
+	}
+
+private:
+	// Seed of the generator (changing it changes every hash, so hash files written with other keys can not be read)
+	static constexpr uint64_t seed = 0x2545F4914F6CDD1DULL;
+
+	// Advance the state and get the next number of the sequence (SplitMix64, every 64 bit number appears once per period and the bits are well mixed)
+	static constexpr uint64_t nextKey(uint64_t& state)
+	{
+		state += 0x9E3779B97F4A7C15ULL;
+		uint64_t mixed = state;
+		mixed = (mixed ^ (mixed >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		mixed = (mixed ^ (mixed >> 27)) * 0x94D049BB133111EBULL;
+		return mixed ^ (mixed >> 31);
+	}
+};
+
+// The keys shared by all the boards
+extern const ZobristKeys zobristKeys;